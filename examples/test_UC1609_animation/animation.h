@@ -0,0 +1,47 @@
+// Generated by extras/tools/uc1609_anim.py frame00.pbm frame01.pbm frame02.pbm frame03.pbm frame04.pbm frame05.pbm frame06.pbm frame07.pbm frame08.pbm frame09.pbm frame10.pbm frame11.pbm --loop --name bootAnimation -o animation.h
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+// bootAnimation: 96x32, keyframe of 92 bytes and 12 frames, 587 bytes (4992 as full frames)
+// data bytes per frame: 17 20 18 27 20 18 15 18 29 20 18 107
+IMAGE(bootAnimation) = {
+  0x60, 0x20, 0x0C, 0x01, 0x5C, 0x00, 0x60, 0x20, 0x85, 0x05, 0x80, 0xC0, 0x60, 0x30, 0x10, 0x10,
+  0xC1, 0x08, 0x00, 0xE8, 0xC1, 0x08, 0x05, 0x10, 0x10, 0x30, 0x60, 0xC0, 0x80, 0xFF, 0x49, 0x00,
+  0x03, 0xF0, 0x0E, 0x03, 0x01, 0x87, 0x00, 0xFF, 0x87, 0x03, 0x01, 0x03, 0x0E, 0xF0, 0x87, 0x01,
+  0xFC, 0x04, 0xC2, 0xF4, 0xF1, 0x04, 0x00, 0xFC, 0x84, 0x04, 0x07, 0x38, 0x60, 0xC0, 0x80, 0x8E,
+  0x04, 0x80, 0xC0, 0x60, 0x38, 0x07, 0x87, 0x01, 0x3F, 0x20, 0xC2, 0x2F, 0xF1, 0x20, 0x00, 0x3F,
+  0x88, 0x04, 0x01, 0x03, 0x06, 0x04, 0x04, 0xC5, 0x08, 0x04, 0x04, 0x04, 0x06, 0x03, 0x01, 0xFF,
+  0x47, 0x00, 0x05, 0x00, 0x0F, 0x01, 0x08, 0x00, 0x14, 0x01, 0xD0, 0x01, 0x0F, 0x05, 0x80, 0x70,
+  0x10, 0x0E, 0x01, 0x01, 0x2A, 0x05, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0x02, 0x2A, 0x05, 0x2F, 0x2F,
+  0x2F, 0x2F, 0x2F, 0x04, 0x00, 0x14, 0x01, 0x10, 0x01, 0x10, 0x09, 0x40, 0x40, 0x60, 0x10, 0x10,
+  0x10, 0x08, 0x04, 0x05, 0x01, 0x2F, 0x05, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0x02, 0x2F, 0x05, 0x2F,
+  0x2F, 0x2F, 0x2F, 0x2F, 0x03, 0x01, 0x10, 0x0A, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x81, 0x83, 0x01, 0x34, 0x04, 0xF4, 0xF4, 0xF4, 0xF4, 0x02, 0x34, 0x04, 0x2F, 0x2F, 0x2F, 0x2F,
+  0x04, 0x01, 0x10, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x01, 0x38,
+  0x04, 0xF4, 0xF4, 0xF4, 0xF4, 0x02, 0x10, 0x09, 0x01, 0x01, 0x03, 0x04, 0x04, 0x04, 0x08, 0x90,
+  0xD0, 0x02, 0x38, 0x04, 0x2F, 0x2F, 0x2F, 0x2F, 0x04, 0x01, 0x3C, 0x05, 0xF4, 0xF4, 0xF4, 0xF4,
+  0xF4, 0x02, 0x10, 0x09, 0x07, 0x04, 0x38, 0x40, 0x80, 0x00, 0x00, 0x80, 0xC0, 0x02, 0x3C, 0x05,
+  0x2F, 0x2F, 0x2F, 0x2F, 0x2F, 0x03, 0x14, 0x01, 0x05, 0x05, 0x01, 0x41, 0x05, 0xF4, 0xF4, 0xF4,
+  0xF4, 0xF4, 0x02, 0x0F, 0x06, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x41, 0x05, 0x2F, 0x2F,
+  0x2F, 0x2F, 0x2F, 0x03, 0x0F, 0x01, 0x0B, 0x03, 0x14, 0x01, 0x04, 0x05, 0x01, 0x46, 0x04, 0xF4,
+  0xF4, 0xF4, 0xF4, 0x02, 0x0B, 0x05, 0xC0, 0x38, 0x04, 0x07, 0x00, 0x02, 0x46, 0x04, 0x2F, 0x2F,
+  0x2F, 0x2F, 0x03, 0x0A, 0x01, 0x05, 0x03, 0x0F, 0x01, 0x08, 0x04, 0x01, 0x4A, 0x04, 0xF4, 0xF4,
+  0xF4, 0xF4, 0x02, 0x06, 0x09, 0xD0, 0x90, 0x08, 0x04, 0x04, 0x04, 0x03, 0x01, 0x01, 0x02, 0x4A,
+  0x04, 0x2F, 0x2F, 0x2F, 0x2F, 0x03, 0x0A, 0x01, 0x04, 0x04, 0x01, 0x05, 0x0A, 0x83, 0x81, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0x4E, 0x05, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0x02,
+  0x06, 0x09, 0xC0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x4E, 0x05, 0x2F, 0x2F,
+  0x2F, 0x2F, 0x2F, 0x03, 0x01, 0x05, 0x0A, 0x03, 0x05, 0x04, 0x08, 0x10, 0x10, 0x10, 0x60, 0x40,
+  0x40, 0x01, 0x53, 0x05, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0x02, 0x53, 0x05, 0x2F, 0x2F, 0x2F, 0x2F,
+  0x2F, 0x04, 0x00, 0x0A, 0x01, 0xD0, 0x01, 0x06, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00, 0x03, 0x0C,
+  0x10, 0x60, 0x01, 0x58, 0x04, 0xF4, 0xF4, 0xF4, 0xF4, 0x02, 0x58, 0x04, 0x2F, 0x2F, 0x2F, 0x2F,
+  0x05, 0x00, 0x0A, 0x01, 0x10, 0x00, 0x0F, 0x01, 0xE8, 0x01, 0x0B, 0x05, 0x00, 0x00, 0x00, 0x00,
+  0xFF, 0x01, 0x2A, 0x32, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+  0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+  0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+  0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x02, 0x2A, 0x32, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+};
+
+#endif
@@ -0,0 +1,37 @@
+/*
+ * Sketch Name:  test_UC1609_animation.ino
+ * Description:  This sketch plays a looping boot animation that only sends the bytes that
+ *               change from one frame to the next.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include <UC1609.h>
+#include <UC1609Animation.h>
+#include "animation.h"  // generated with extras/tools/uc1609_anim.py
+
+// define control pins to be used for the display
+#define CD  PIN_PC0
+#define RST PIN_PC2    // Set it to -1 if share with MCU's NRST pin
+#define CS  PIN_PC1
+
+// System default contrast = 0x49, user however can change it with value 0x00 to 0xFE
+const uint8_t contrast=0x38;
+
+UC1609  lcd(CS, CD, RST);
+UC1609Animation player(lcd);
+
+
+void setup() {
+  lcd.begin(contrast);
+  lcd.clearDisplay();
+  lcd.setCursor(66, 6);
+  lcd.print("booting");
+  player.begin(bootAnimation, 48, 8, 100, true);   // 96x32 at (48, 8), 10 frames per second
+}
+
+
+void loop() {
+  player.update();
+  // other work of the sketch goes here, the animation only needs update() to be called
+}
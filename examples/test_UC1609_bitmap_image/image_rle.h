@@ -0,0 +1,47 @@
+#ifndef __DISPLAY_IMAGE_RLE_H
+#define __DISPLAY_IMAGE_RLE_H
+
+// Compressed copies of the images in image.h for drawCompressedImage(), generated with
+// extras/tools/uc1609_compress.py image.h <array> <width> <height>
+
+// bitmapRle: 192x64, 287 bytes compressed from 1536
+IMAGE(bitmapRle) = {
+  192, 64,  // width, height
+  0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0x00, 0xFF, 0x42, 0x00, 0xC1, 0x06, 0xC1, 0xFE, 0xC1, 0x06, 0x81,
+  0xC1, 0xFE, 0xC3, 0xC6, 0x81, 0x03, 0xE0, 0xF8, 0xFC, 0x1E, 0xC3, 0x06, 0x82, 0xC1, 0xFE, 0xC2,
+  0xC0, 0xC1, 0xFE, 0x85, 0x07, 0x3C, 0x7E, 0x42, 0xC2, 0x82, 0x82, 0x06, 0x00, 0xC2, 0x02, 0x01,
+  0xFE, 0xFE, 0xC1, 0x02, 0x81, 0x01, 0xFE, 0xFE, 0x85, 0x01, 0xFE, 0xFE, 0x82, 0x01, 0xFE, 0xFE,
+  0xC2, 0x06, 0x02, 0x0C, 0xFC, 0xF0, 0x81, 0x03, 0x02, 0xFE, 0xFE, 0x02, 0x81, 0x02, 0xF8, 0xFC,
+  0x06, 0xC3, 0x02, 0x02, 0x06, 0xFC, 0xF8, 0x85, 0xC1, 0xFE, 0x06, 0x06, 0x06, 0x0E, 0x1C, 0xFC,
+  0xF8, 0xF0, 0x82, 0xC1, 0xFE, 0xC3, 0xC6, 0x82, 0x07, 0x78, 0xFC, 0xFE, 0xC6, 0x86, 0x86, 0x0E,
+  0x0C, 0x81, 0x01, 0x06, 0x06, 0xC1, 0xFE, 0x01, 0x06, 0x06, 0x81, 0x05, 0xE0, 0xF8, 0xFC, 0x1C,
+  0x0E, 0x0E, 0xC1, 0x86, 0x01, 0x8E, 0x8E, 0x82, 0xC1, 0xFE, 0x03, 0x7C, 0xF8, 0xE0, 0xC0, 0x81,
+  0xC1, 0xFE, 0x8A, 0xC1, 0x3F, 0x84, 0xC1, 0x3F, 0xC3, 0x30, 0x81, 0x04, 0x03, 0x0F, 0x1F, 0x3C,
+  0x38, 0xC2, 0x30, 0x82, 0xC1, 0x3F, 0xC2, 0x01, 0xC1, 0x3F, 0x85, 0xC3, 0x30, 0x01, 0x3F, 0x0F,
+  0x84, 0x01, 0x3F, 0x3F, 0x84, 0x02, 0x07, 0x1F, 0x18, 0xC2, 0x30, 0x02, 0x18, 0x1F, 0x07, 0x82,
+  0x01, 0x3F, 0x3F, 0xC1, 0x30, 0x03, 0x38, 0x1C, 0x0F, 0x07, 0x81, 0x03, 0x30, 0x3F, 0x3F, 0x30,
+  0x81, 0x02, 0x07, 0x1F, 0x18, 0xC3, 0x30, 0x02, 0x18, 0x1F, 0x07, 0x85, 0xC1, 0x3F, 0xC1, 0x30,
+  0x03, 0x38, 0x1F, 0x0F, 0x07, 0x82, 0xC1, 0x3F, 0xC3, 0x30, 0x82, 0xC1, 0x30, 0x04, 0x31, 0x33,
+  0x3F, 0x3F, 0x1E, 0x81, 0x01, 0x30, 0x30, 0xC1, 0x3F, 0x01, 0x30, 0x30, 0x81, 0x0A, 0x07, 0x1F,
+  0x3F, 0x3C, 0x30, 0x30, 0x31, 0x39, 0x3F, 0x3F, 0x1F, 0x82, 0xC1, 0x3F, 0x81, 0x03, 0x03, 0x07,
+  0x1F, 0x3C, 0xC1, 0x3F, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0x00, 0xFF, 0x44, 0x00,
+};
+
+// thermometerIconRle: 24x24, 38 bytes compressed from 72
+IMAGE(thermometerIconRle) = {
+  24, 24,  // width, height
+  0x88, 0x06, 0xF8, 0x04, 0x02, 0x02, 0x04, 0xF8, 0x00, 0xC1, 0x80, 0x8D, 0x09, 0xFF, 0x00, 0xF8,
+  0xF8, 0x00, 0xFF, 0x00, 0xAA, 0xAA, 0x88, 0x8B, 0x09, 0x1C, 0x3E, 0x61, 0xCC, 0xDF, 0xDF, 0xCC,
+  0x61, 0x3E, 0x1C, 0x86,
+};
+
+// humidityIconRle: 24x24, 55 bytes compressed from 72
+IMAGE(humidityIconRle) = {
+  24, 24,  // width, height
+  0x85, 0x0B, 0x80, 0x60, 0x10, 0x08, 0x04, 0x02, 0x02, 0x04, 0x08, 0x10, 0x60, 0x80, 0x88, 0x02,
+  0xE0, 0x1C, 0x03, 0x81, 0x05, 0x18, 0x24, 0x24, 0x98, 0x60, 0x10, 0x83, 0x02, 0x03, 0x1C, 0xE0,
+  0x85, 0x11, 0x03, 0x0C, 0x10, 0x20, 0x40, 0x40, 0x84, 0x83, 0x80, 0x86, 0x89, 0x89, 0x46, 0x40,
+  0x20, 0x10, 0x0C, 0x03, 0x82,
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * File Name:    Arduino.cpp
+ * Description:  Host stand-in implementation of the Arduino core and SPI functions used by the
+ *               UC1609 library. Time is virtual: it only advances with SPI traffic and delays,
+ *               which keeps every benchmark run repeatable.
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "SPI.h"
+
+static HostBus *_bus = nullptr;
+static uint64_t _nanos = 0;
+static uint8_t _pins[256];
+
+SPIClass SPI;
+
+void hostAttachBus(HostBus *bus) {
+  _bus = bus;
+}
+
+uint64_t hostNanos() {
+  return _nanos;
+}
+
+void hostAdvance(uint64_t ns) {
+  _nanos += ns;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void) pin;
+  (void) mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  _pins[pin] = level ? HIGH : LOW;
+  if (_bus) _bus->pinWrite(pin, _pins[pin]);
+}
+
+int digitalRead(uint8_t pin) {
+  return _pins[pin];
+}
+
+void (*hostYieldHook)() = nullptr;
+
+void delay(unsigned long ms) {
+  _nanos += (uint64_t) ms * 1000000ULL;
+}
+
+void delayMicroseconds(unsigned int us) {
+  _nanos += (uint64_t) us * 1000ULL;
+}
+
+unsigned long millis() {
+  return (unsigned long) (_nanos / 1000000ULL);
+}
+
+unsigned long micros() {
+  return (unsigned long) (_nanos / 1000ULL);
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (write(*buffer++)) n++;
+    else break;
+  }
+  return n;
+}
+
+size_t Print::print(long n, int base) {
+  if (n < 0 && base == 10) {
+    size_t t = print('-');
+    return t + print((unsigned long) -n, base);
+  }
+  return print((unsigned long) n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) base = 10;
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(double n, int digits) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+void SPIClass::beginTransaction(SPISettings settings) {
+  _clock = settings.clock;
+  if (_bus) _bus->beginTransaction(_clock);
+}
+
+void SPIClass::endTransaction() {
+  if (_bus) _bus->endTransaction();
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  _nanos += 8000000000ULL / _clock;
+  return _bus ? _bus->transfer(data) : 0;
+}
+
+void SPIClass::transfer(void *buf, size_t count) {
+  uint8_t *p = (uint8_t *) buf;
+  for (size_t i = 0; i < count; i++) {
+    p[i] = transfer(p[i]);
+  }
+}
@@ -0,0 +1,70 @@
+/*
+ * File Name:    Arduino.h
+ * Description:  Minimal host (Linux) stand-in for the Arduino core, just enough for the UC1609
+ *               library to compile and run unmodified against UC1609Emulator. Pin writes and
+ *               delays are routed to the attached HostBus (see HostBus.h).
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_HOST_ARDUINO_H
+#define UC1609_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "HostBus.h"
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+// from binary.h, only the constants used by the library
+#define B00000110 6
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+// yield() runs hostYieldHook, e.g. to let a simulated DMA transfer progress while the
+// library waits for it
+extern void (*hostYieldHook)();
+inline void yield() { if (hostYieldHook) hostYieldHook(); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t ch) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) {
+      if (str == nullptr) return 0;
+      return write((const uint8_t *) str, strlen(str));
+    }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *) buffer, size); }
+
+    size_t print(const char str[]) { return write(str); }
+    size_t print(char c) { return write((uint8_t) c); }
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long) n, base); }
+    size_t print(int n, int base = DEC) { return print((long) n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long) n, base); }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int fmt) { size_t n = print(value, fmt); return n + println(); }
+};
+
+#endif
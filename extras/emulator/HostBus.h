@@ -0,0 +1,31 @@
+/*
+ * File Name:    HostBus.h
+ * Description:  Hook interface between the host stand-in Arduino/SPI layer and a device model.
+ *               Every digitalWrite(), SPI transaction and SPI byte issued by the library is
+ *               forwarded to the attached HostBus so that a model (e.g. UC1609Emulator) can
+ *               observe the wire traffic exactly as the panel would see it.
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_HOST_BUS_H
+#define UC1609_HOST_BUS_H
+
+#include <stdint.h>
+
+class HostBus {
+  public:
+    virtual ~HostBus() {}
+    virtual void pinWrite(uint8_t pin, uint8_t level) { (void) pin; (void) level; }
+    virtual void beginTransaction(uint32_t clock) { (void) clock; }
+    virtual void endTransaction() {}
+    virtual uint8_t transfer(uint8_t data) { (void) data; return 0; }
+};
+
+// attach a device model to the stand-in layer, pass nullptr to detach
+void hostAttachBus(HostBus *bus);
+
+// virtual time in nanoseconds, advanced by SPI traffic and delay()/delayMicroseconds()
+uint64_t hostNanos();
+void hostAdvance(uint64_t ns);
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * File Name:    SPI.h
+ * Description:  Minimal host (Linux) stand-in for the Arduino SPI library. Transactions and
+ *               bytes are forwarded to the attached HostBus. Like most Arduino cores the block
+ *               transfer() overwrites the buffer with the received bytes, so code that reuses
+ *               a buffer after sending it misbehaves here just as it would on hardware.
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_HOST_SPI_H
+#define UC1609_HOST_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings {
+  public:
+    SPISettings(uint32_t clock = 4000000UL, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0):
+      clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass {
+  public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings settings);
+    void endTransaction();
+    uint8_t transfer(uint8_t data);
+    void transfer(void *buf, size_t count);
+
+  private:
+    uint32_t _clock{4000000UL};
+};
+
+extern SPIClass SPI;
+
+#endif
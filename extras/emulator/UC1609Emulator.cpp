@@ -0,0 +1,257 @@
+/*
+ * File Name:    UC1609Emulator.cpp
+ * Description:  Host-side model of the UC1609C controller, see UC1609Emulator.h.
+ *               Command decoding follows the UC1609C datasheet command table; the register
+ *               names used in the comments are the REG_* macros from UC1609.h.
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "UC1609Emulator.h"
+
+UC1609Emulator::UC1609Emulator(uint8_t cs, uint8_t cd, uint8_t rst): _csPin(cs), _cdPin(cd), _rstPin(rst) {
+  memset(_ram, 0, sizeof(_ram));
+  reset();
+  resetStats();
+  hostAttachBus(this);
+}
+
+UC1609Emulator::~UC1609Emulator() {
+  hostAttachBus(nullptr);
+}
+
+/*
+ * Power-on / REG_SYSTEM_RESET defaults. The display RAM is not affected by a reset.
+ * The address control register defaults to column auto-increment with rollover, which
+ * is what lets a 1536-byte data burst fill the whole RAM from address (0, 0).
+ */
+void UC1609Emulator::reset() {
+  _col = 0;
+  _page = 0;
+  _scrollLine = 0;
+  _mapping = 0;
+  _vbias = 0x49;
+  _addressControl = 0x01;
+  _pendingCommand = 0;
+  _inverse = false;
+  _allPixelOn = false;
+  _displayEnabled = false;
+  _unknownCommands = 0;
+}
+
+void UC1609Emulator::resetStats() {
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+void UC1609Emulator::pinWrite(uint8_t pin, uint8_t level) {
+  if (pin == _csPin) {
+    _stats.pinWrites++;
+    if (level != _cs) _stats.csToggles++;
+    _cs = level;
+    if (_cs) _pendingCommand = 0;   // a double-byte command does not survive a CS release
+  }
+  else if (pin == _cdPin) {
+    _stats.pinWrites++;
+    if (level != _cd) _stats.cdToggles++;
+    _cd = level;
+  }
+  else if (pin == _rstPin) {
+    _stats.pinWrites++;
+    if (level == 0) reset();
+  }
+}
+
+void UC1609Emulator::beginTransaction(uint32_t clock) {
+  _clock = clock;
+  _stats.transactions++;
+}
+
+void UC1609Emulator::endTransaction() {
+}
+
+uint8_t UC1609Emulator::transfer(uint8_t data) {
+  if (_clock) _stats.wireNanos += 8000000000ULL / _clock;
+  if (_cs) {
+    _stats.strayBytes++;
+    return 0;
+  }
+  _stats.bytes++;
+  if (_cd) {
+    _stats.dataBytes++;
+    _data(data);
+  }
+  else {
+    _stats.commandBytes++;
+    _command(data);
+  }
+  return 0;
+}
+
+void UC1609Emulator::_command(uint8_t cmd) {
+  if (_pendingCommand) {
+    if (_pendingCommand == 0x81) _vbias = cmd;   // REG_VBIAS_POT second byte
+    _pendingCommand = 0;
+    return;
+  }
+
+  if ((cmd & 0xF0) == 0x00) {                   // REG_COL_ADDR_L
+    _col = (_col & 0xF0) | (cmd & 0x0F);
+  }
+  else if ((cmd & 0xF0) == 0x10) {              // REG_COL_ADDR_H
+    _col = (_col & 0x0F) | (cmd & 0x0F) << 4;
+  }
+  else if ((cmd & 0xFC) == 0x20) {              // REG_TEMP_COMP_REG
+  }
+  else if ((cmd & 0xF8) == 0x28) {              // REG_POWER_CONTROL
+  }
+  else if ((cmd & 0xC0) == 0x40) {              // REG_SCROLL
+    _scrollLine = cmd & 0x3F;
+  }
+  else if (cmd == 0x81 || cmd == 0xF1) {        // REG_VBIAS_POT, set COM end (double-byte)
+    _pendingCommand = cmd;
+  }
+  else if ((cmd & 0xF8) == 0x88) {              // REG_ADDRESS_CONTROL
+    _addressControl = cmd & 0x07;
+  }
+  else if ((cmd & 0xFC) == 0xA0) {              // REG_FRAMERATE_REG
+  }
+  else if ((cmd & 0xFE) == 0xA4) {              // REG_ALL_PIXEL_ON
+    _allPixelOn = cmd & 0x01;
+  }
+  else if ((cmd & 0xFE) == 0xA6) {              // REG_INVERSE_DISPLAY
+    _inverse = cmd & 0x01;
+  }
+  else if ((cmd & 0xFE) == 0xAE) {              // REG_DISPLAY_ENABLE
+    _displayEnabled = cmd & 0x01;
+  }
+  else if ((cmd & 0xF0) == 0xB0) {              // REG_PAGE_ADDER
+    _page = cmd & 0x0F;
+  }
+  else if ((cmd & 0xF8) == 0xC0) {              // REG_MAPPING_CTRL
+    _mapping = cmd & 0x07;
+  }
+  else if (cmd == 0xE2) {                       // REG_SYSTEM_RESET
+    uint32_t unknown = _unknownCommands;
+    reset();
+    _unknownCommands = unknown;
+  }
+  else if (cmd == 0xE3) {                       // NOP
+  }
+  else if ((cmd & 0xFC) == 0xE8) {              // REG_BIAS_RATIO
+  }
+  else {
+    _unknownCommands++;
+  }
+}
+
+void UC1609Emulator::_data(uint8_t data) {
+  if (_page < EMU_PAGES && _col < EMU_COLUMNS)
+    _ram[_page][_col] = data;
+
+  bool rollover = _addressControl & 0x01;
+  if (_addressControl & 0x02) {                 // page auto-increment
+    if (_page < EMU_PAGES - 1) {
+      _page++;
+    }
+    else if (rollover) {
+      _page = 0;
+      _col = (_col + 1) % EMU_COLUMNS;
+    }
+  }
+  else {                                        // column auto-increment
+    if (_col < EMU_COLUMNS - 1) {
+      _col++;
+    }
+    else if (rollover) {
+      _col = 0;
+      _page = (_page + 1) % EMU_PAGES;
+    }
+  }
+}
+
+/*
+ * NORMAL_ORIENTATION (MY set) is the upright view of the module, so the vertical
+ * mirror is applied when MY is clear; MX mirrors the columns.
+ */
+bool UC1609Emulator::pixel(uint8_t x, uint8_t y) const {
+  if (!_displayEnabled) return false;
+  if (_allPixelOn) return true;
+
+  uint8_t ry = (_mapping & 0x04) ? y : EMU_ROWS - 1 - y;
+  ry = (ry + _scrollLine) % EMU_ROWS;
+  uint8_t rx = (_mapping & 0x02) ? EMU_COLUMNS - 1 - x : x;
+  bool on = (_ram[ry >> 3][rx] >> (ry & 0x07)) & 0x01;
+  return on != _inverse;
+}
+
+bool UC1609Emulator::writePBM(const char *path) const {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  fprintf(f, "P4\n%d %d\n", EMU_COLUMNS, EMU_ROWS);
+  for (uint8_t y = 0; y < EMU_ROWS; y++) {
+    for (uint8_t x = 0; x < EMU_COLUMNS; x += 8) {
+      uint8_t b = 0;
+      for (uint8_t i = 0; i < 8; i++) {
+        if (pixel(x + i, y)) b |= 0x80 >> i;
+      }
+      fputc(b, f);
+    }
+  }
+  return fclose(f) == 0;
+}
+
+static int _readToken(FILE *f) {
+  int c = fgetc(f);
+  while (c == '#' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+    if (c == '#') {
+      while (c != '\n' && c != EOF) c = fgetc(f);
+    }
+    c = fgetc(f);
+  }
+  return c;
+}
+
+static long _readNumber(FILE *f) {
+  int c = _readToken(f);
+  long n = 0;
+  while (c >= '0' && c <= '9') {
+    n = n * 10 + (c - '0');
+    c = fgetc(f);
+  }
+  return n;
+}
+
+long UC1609Emulator::comparePBM(const char *path) const {
+  FILE *f = fopen(path, "rb");
+  if (!f) return -1;
+
+  long diff = -1;
+  if (fgetc(f) == 'P') {
+    int kind = fgetc(f);
+    long w = _readNumber(f);
+    long h = _readNumber(f);
+    if ((kind == '1' || kind == '4') && w == EMU_COLUMNS && h == EMU_ROWS) {
+      int byte = 0;
+      diff = 0;
+      for (uint8_t y = 0; y < EMU_ROWS && diff >= 0; y++) {
+        for (uint8_t x = 0; x < EMU_COLUMNS; x++) {
+          int bit;
+          if (kind == '4') {
+            if ((x & 0x07) == 0) byte = fgetc(f);
+            bit = (byte >> (7 - (x & 0x07))) & 0x01;
+            if (byte == EOF) { diff = -1; break; }
+          }
+          else {
+            int c = _readToken(f);
+            if (c != '0' && c != '1') { diff = -1; break; }
+            bit = c - '0';
+          }
+          if (bit != (int) pixel(x, y)) diff++;
+        }
+      }
+    }
+  }
+  fclose(f);
+  return diff;
+}
@@ -0,0 +1,93 @@
+/*
+ * File Name:    UC1609Emulator.h
+ * Description:  Host-side model of the UC1609C controller. It watches the CS/CD/RST pins and the
+ *               SPI bytes produced by the library, decodes the command set defined in UC1609.h
+ *               into the controller registers, writes data bytes into an emulated 192x64 display
+ *               RAM and keeps wire statistics so the cost of every API call can be measured.
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_EMULATOR_H
+#define UC1609_EMULATOR_H
+
+#include <stdint.h>
+#include "HostBus.h"
+
+#define EMU_COLUMNS 192
+#define EMU_PAGES   8
+#define EMU_ROWS    64
+
+struct UC1609WireStats {
+  uint32_t bytes;          // all bytes clocked out while CS was asserted
+  uint32_t commandBytes;   // bytes clocked with CD low
+  uint32_t dataBytes;      // bytes clocked with CD high
+  uint32_t strayBytes;     // bytes clocked while CS was de-asserted (ignored by the panel)
+  uint32_t transactions;   // SPI.beginTransaction() calls
+  uint32_t csToggles;      // CS level changes
+  uint32_t cdToggles;      // CD level changes
+  uint32_t pinWrites;      // digitalWrite() calls on CS/CD/RST, including redundant ones
+  uint64_t wireNanos;      // virtual time spent clocking bytes
+
+  float commandRatio() const { return bytes ? (float) commandBytes / bytes : 0.0f; }
+};
+
+class UC1609Emulator: public HostBus {
+  public:
+    UC1609Emulator(uint8_t cs, uint8_t cd, uint8_t rst = 0xFF);
+    ~UC1609Emulator();
+
+    void reset();
+    void resetStats();
+    const UC1609WireStats &stats() const { return _stats; }
+
+    // controller state
+    uint8_t ram(uint8_t page, uint8_t col) const { return _ram[page][col]; }
+    uint8_t column() const { return _col; }
+    uint8_t page() const { return _page; }
+    uint8_t scrollLine() const { return _scrollLine; }
+    uint8_t mapping() const { return _mapping; }
+    uint8_t vbias() const { return _vbias; }
+    uint8_t addressControl() const { return _addressControl; }
+    bool inverse() const { return _inverse; }
+    bool allPixelOn() const { return _allPixelOn; }
+    bool displayEnabled() const { return _displayEnabled; }
+    uint32_t unknownCommands() const { return _unknownCommands; }
+
+    // visible pixel after scroll, mirroring, inverse and all-pixel-on are applied
+    bool pixel(uint8_t x, uint8_t y) const;
+
+    // dump the visible screen as binary PBM (P4), return false on I/O error
+    bool writePBM(const char *path) const;
+    // compare the visible screen with a PBM (P1 or P4), return the number of differing
+    // pixels, or -1 if the file cannot be read or has the wrong size
+    long comparePBM(const char *path) const;
+
+    // HostBus
+    void pinWrite(uint8_t pin, uint8_t level) override;
+    void beginTransaction(uint32_t clock) override;
+    void endTransaction() override;
+    uint8_t transfer(uint8_t data) override;
+
+  private:
+    uint8_t _csPin, _cdPin, _rstPin;
+    uint8_t _cs{1}, _cd{1};
+    uint32_t _clock{0};
+    UC1609WireStats _stats;
+
+    uint8_t _ram[EMU_PAGES][EMU_COLUMNS];
+    uint8_t _col, _page;
+    uint8_t _scrollLine;
+    uint8_t _mapping;
+    uint8_t _vbias;
+    uint8_t _addressControl;
+    uint8_t _pendingCommand;  // first byte of a double-byte command, 0 if none
+    bool _inverse;
+    bool _allPixelOn;
+    bool _displayEnabled;
+    uint32_t _unknownCommands;
+
+    void _command(uint8_t cmd);
+    void _data(uint8_t data);
+};
+
+#endif
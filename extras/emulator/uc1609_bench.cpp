@@ -0,0 +1,1427 @@
+/*
+ * File Name:    uc1609_bench.cpp
+ * Description:  Host benchmark for the UC1609 library. Runs each API call against the
+ *               UC1609Emulator and reports the SPI wire cost (bytes, transactions, CS/CD
+ *               toggles, command-vs-data ratio and wire time at SPI_CLOCK).
+ *               --dump DIR    writes the visible screen after each scenario to DIR/<name>.pbm
+ *               --golden DIR  compares each screen with DIR/<name>.pbm, exit 1 on mismatch
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "UC1609.h"
+#include "UC1609Animation.h"
+#include "UC1609Bus.h"
+#include "UC1609Channel.h"
+#include "UC1609DrawQueue.h"
+#include "UC1609Emulator.h"
+#include "UC1609Transport.h"
+#include "../../examples/test_UC1609_bitmap_image/image.h"
+#include "../../examples/test_UC1609_bitmap_image/image_rle.h"
+#include "../../examples/test_UC1609_animation/animation.h"
+
+#define PIN_CS  10
+#define PIN_CD  9
+#define PIN_RST 8
+
+struct Scenario {
+  const char *name;
+  std::function<void(UC1609 &)> setup;   // runs after begin(), not measured
+  std::function<void(UC1609 &)> action;  // measured
+};
+
+static void noSetup(UC1609 &lcd) { (void) lcd; }
+
+static const char line32[] = "12345678901234567890123456789012";
+static UC1609FrameBuffer frameBuffer;
+static UC1609FrameBuffer backBuffer;
+static UC1609AsyncState asyncState;
+
+/*
+ * Simulated DMA back-end for flushAsync(): start() only takes the burst, tick() clocks
+ * a few of its bytes "in the background" and reports the completion like a DMA
+ * interrupt would. Installed as the yield() hook, it also progresses while the library
+ * waits for the transfer.
+ */
+class SimDma: public UC1609AsyncBackend {
+  public:
+    SimDma(UC1609 &lcd): _lcd(lcd) { _active = this; hostYieldHook = [] { if (_active) _active->tick(8); }; }
+    ~SimDma() { _active = nullptr; hostYieldHook = nullptr; }
+    void start(const uint8_t *data, uint8_t len) override { _data = data; _len = len; _sent = 0; starts++; }
+    void tick(uint8_t bytes) {
+      while (bytes-- && _data) {
+        SPI.transfer(_data[_sent++]);
+        if (_sent == _len) {
+          _data = nullptr;
+          _lcd.transferDone();
+        }
+      }
+    }
+    uint32_t starts{0};
+
+  private:
+    static SimDma *_active;
+    UC1609 &_lcd;
+    const uint8_t *_data{nullptr};
+    uint8_t _len{0};
+    uint8_t _sent{0};
+};
+
+SimDma *SimDma::_active = nullptr;
+
+static void dashboard(UC1609 &lcd, const char *time) {
+  lcd.setCursor(0, 0);
+  lcd.print("Status: running");
+  lcd.setCursor(0, 2);
+  lcd.print("Time:   ");
+  lcd.print(time);
+  lcd.setCursor(0, 4);
+  lcd.print("Temp:   24.8c");
+  lcd.drawImage(168, 40, 24, 24, humidityIcon);
+}
+
+static UC1609TextBuffer textBuffer;
+
+static void textScreen(UC1609 &lcd, const char *time) {
+  lcd.setCursor(0, 0);
+  lcd.print("Status: running");
+  lcd.setCursor(0, 2);
+  lcd.print("Time:   ");
+  lcd.print(time);
+  lcd.setCursor(0, 4);
+  lcd.print("Temp:   24.8c");
+  lcd.setCursor(0, 7);
+  textBuffer.setInverse(true);
+  lcd.print(" MENU ");
+  textBuffer.setInverse(false);
+}
+
+static uint8_t strip[4 * UC1609_COLUMNS];
+
+static void stripScreen(UC1609 &lcd) {
+  lcd.drawLine(7, 0x18);
+  dashboard(lcd, "12:34:57");
+}
+
+static void stripSprites(UC1609 &lcd) {
+  lcd.setCursor(0, 2);
+  lcd.print("under the sprites");
+  lcd.drawSprite(20, 11, 24, 24, humidityIcon, SPRITE_MASKED, thermometerIcon);
+  lcd.drawSprite(60, 13, 24, 24, humidityIcon, SPRITE_TRANSPARENT);
+}
+
+static const uint8_t graph[] = {40, 44, 41, 50, 47, 52, 58, 55, 49, 61, 57, 53, 45, 48, 42, 39};
+
+static void gauge(UC1609 &lcd) {
+  lcd.drawCircle(31, 31, 30);
+  lcd.drawCircle(31, 31, 2);
+  lcd.drawSegment(31, 31, 12, 9);
+  lcd.drawRect(70, 8, 118, 50);
+  for (uint8_t i = 1; i < sizeof(graph); i++) {
+    lcd.drawSegment(72 + (i - 1) * 7, graph[i - 1], 72 + i * 7, graph[i]);
+  }
+  lcd.fillBox(72, 10, 40, 7);
+  lcd.fillCircle(170, 20, 9, PIXEL_INVERT);
+}
+
+static UC1609DrawOp queueOps[12];
+
+static void queuedScreen(UC1609DrawQueue &queue) {
+  queue.clear();
+  queue.text(0, 0, "Queued drawing, 200us per tick");
+  queue.text(0, 2, "Temp:");
+  queue.image(48, 32, 24, 24, thermometerIcon);
+  queue.fill(96, 4, 96, 3, 0x55);
+  queue.command(QUEUE_INVERT, 1);
+}
+
+static UC1609ChannelSlot channelSlots[8];
+
+static std::vector<Scenario> scenarios() {
+  return {
+    {"begin", noSetup, [](UC1609 &lcd) { lcd.begin(); }},
+    {"clearDisplay", noSetup, [](UC1609 &lcd) { lcd.clearDisplay(); }},
+    {"setCursor", noSetup, [](UC1609 &lcd) { lcd.setCursor(96, 3); }},
+    {"write_char", [](UC1609 &lcd) { lcd.setCursor(0, 0); }, [](UC1609 &lcd) { lcd.write('A'); }},
+    {"print_line", [](UC1609 &lcd) { lcd.setCursor(0, 0); }, [](UC1609 &lcd) { lcd.print(line32); }},
+    {"print_wrap", [](UC1609 &lcd) { lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print(line32); lcd.print("wrapped onto the second line"); }},
+    {"print_newline", [](UC1609 &lcd) { lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print("first\r\nsecond\tTAB\r\nthird"); }},
+    {"print_overwrite", [](UC1609 &lcd) { lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print("Count: 1"); lcd.print("\rCount: 2\b3"); }},
+    {"print_line_batch", [](UC1609 &lcd) { lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { UC1609Batch batch(lcd); lcd.print(line32); }},
+    {"write_char_2x", [](UC1609 &lcd) { lcd.setFontScale(2); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.write('A'); }},
+    {"print_line_2x", [](UC1609 &lcd) { lcd.setFontScale(2); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print("Double-size 0123"); }},
+    {"print_line_2x_batch", [](UC1609 &lcd) { lcd.setFontScale(2); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.beginBatch(); lcd.print("Double-size 0123"); lcd.endBatch(); }},
+    {"print_line_2x_table", [](UC1609 &lcd) {
+        lcd.setDoubleSizeFont(UC1609_DOUBLE_SIZE(font5x7)); lcd.setFontScale(2); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print("Double-size 0123"); }},
+    {"print_line_2x_noaa", [](UC1609 &lcd) { lcd.setFontScale(2); lcd.setAntiAliasing(false); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print("Double-size 0123"); }},
+    {"write_char_3x", [](UC1609 &lcd) { lcd.setFontScale(3); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.write('A'); }},
+    {"print_line_3x", [](UC1609 &lcd) { lcd.setFontScale(3); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print("Scale 3 0123"); }},
+    {"print_line_4x", [](UC1609 &lcd) { lcd.setFontScale(4); lcd.setCursor(0, 0); },
+      [](UC1609 &lcd) { lcd.print("4x 12.5"); }},
+    {"drawLine", noSetup, [](UC1609 &lcd) { lcd.drawLine(3, 0x81); }},
+    {"clearLine", [](UC1609 &lcd) { lcd.drawLine(3, 0xFF); }, [](UC1609 &lcd) { lcd.clearLine(3); }},
+    {"drawLine_then_print", [](UC1609 &lcd) { lcd.print("title"); }, [](UC1609 &lcd) { lcd.drawLine(1, 0x18); lcd.print("next"); }},
+    {"fillRect", noSetup, [](UC1609 &lcd) { lcd.fillRect(40, 2, 100, 4, 0xFF); }},
+    {"fillRect_clip", noSetup, [](UC1609 &lcd) { lcd.fillRect(150, 6, 100, 4, 0x55); }},
+    {"drawImage_full", noSetup, [](UC1609 &lcd) { lcd.drawImage(0, 0, 192, 64, bitmap); }},
+    {"drawImage_icon", noSetup, [](UC1609 &lcd) { lcd.drawImage(70, 0, 24, 24, thermometerIcon); }},
+    {"compressed_full", noSetup, [](UC1609 &lcd) { lcd.drawCompressedImage(0, 0, bitmapRle); }},
+    {"compressed_icon", noSetup, [](UC1609 &lcd) { lcd.drawCompressedImage(70, 0, thermometerIconRle); }},
+    {"compressed_clip", noSetup, [](UC1609 &lcd) {
+        lcd.drawCompressedImage(100, 16, bitmapRle); lcd.drawCompressedImage(180, 48, humidityIconRle); }},
+    {"anim_keyframe", noSetup, [](UC1609 &lcd) { UC1609Animation player(lcd); player.begin(bootAnimation, 48, 8, 100); }},
+    {"anim_frames", noSetup, [](UC1609 &lcd) {
+        UC1609Animation player(lcd); player.begin(bootAnimation, 48, 8, 100);
+        while (player.isRunning()) player.drawFrame(); }},
+    {"anim_playback_1s", noSetup, [](UC1609 &lcd) {
+        UC1609Animation player(lcd); player.begin(bootAnimation, 48, 8, 100, true);
+        for (unsigned long start = millis(); millis() - start < 1000; delay(1)) player.update(); }},
+    {"sprite_subpage", noSetup, [](UC1609 &lcd) { lcd.drawSprite(30, 13, 24, 24, thermometerIcon); }},
+    {"sprite_clipped", noSetup, [](UC1609 &lcd) {
+        lcd.drawSprite(-10, -5, 24, 24, thermometerIcon); lcd.drawSprite(180, 50, 24, 24, humidityIcon); }},
+    {"sprite_move", [](UC1609 &lcd) { lcd.drawSprite(80, 20, 24, 24, thermometerIcon); },
+      [](UC1609 &lcd) { lcd.drawSprite(81, 21, 24, 24, thermometerIcon); }},
+    {"sprite_transparent_fb", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); lcd.setCursor(0, 2); lcd.print("under the sprite"); lcd.flush(); },
+      [](UC1609 &lcd) { lcd.drawSprite(20, 11, 24, 24, humidityIcon, SPRITE_TRANSPARENT); lcd.flush(); }},
+    {"sprite_strip", noSetup, [](UC1609 &lcd) { lcd.renderStrips(strip, 2, stripSprites); }},
+    {"pixels_fb", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); },
+      [](UC1609 &lcd) { gauge(lcd); lcd.flush(); }},
+    {"pixels_strip", noSetup, [](UC1609 &lcd) { lcd.renderStrips(strip, 2, gauge); }},
+    {"pixels_invert_fb", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); lcd.fillRect(0, 2, 192, 4, 0xFF); lcd.flush(); },
+      [](UC1609 &lcd) { lcd.fillBox(-5, 5, 60, 30, PIXEL_INVERT); lcd.drawSegment(100, 63, 191, 0, PIXEL_OFF); lcd.flush(); }},
+    {"fb_flush_full", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); dashboard(lcd, "12:34:56"); },
+      [](UC1609 &lcd) { lcd.flush(); }},
+    {"fb_flush_async", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); lcd.setAsyncState(&asyncState); dashboard(lcd, "12:34:56"); },
+      [](UC1609 &lcd) { lcd.flushAsync(); while (lcd.isBusy()) lcd.service(); }},
+    {"fb_flush_async_dma", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); lcd.setAsyncState(&asyncState); dashboard(lcd, "12:34:56"); },
+      [](UC1609 &lcd) {
+        SimDma dma(lcd); lcd.setAsyncBackend(&dma); lcd.flushAsync();
+        while (lcd.isBusy()) { dma.tick(16); lcd.service(); }
+        lcd.setAsyncBackend(nullptr); }},
+    {"fb_flush_update", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); dashboard(lcd, "12:34:56"); lcd.flush(); },
+      [](UC1609 &lcd) { dashboard(lcd, "12:34:57"); lcd.flush(); }},
+    {"strip_redraw_1", [](UC1609 &lcd) { dashboard(lcd, "12:34:56"); },
+      [](UC1609 &lcd) { lcd.renderStrips(strip, 1, stripScreen); }},
+    {"strip_redraw_3", [](UC1609 &lcd) { dashboard(lcd, "12:34:56"); },
+      [](UC1609 &lcd) { lcd.renderStrips(strip, 3, stripScreen); }},
+    {"strip_redraw_fb", [](UC1609 &lcd) { lcd.setFrameBuffer(&frameBuffer); dashboard(lcd, "12:34:56"); lcd.flush(); },
+      [](UC1609 &lcd) { lcd.clearDisplay(); lcd.renderStrips(strip, 1, stripScreen); }},
+    {"direct_redraw", [](UC1609 &lcd) { dashboard(lcd, "12:34:56"); },
+      [](UC1609 &lcd) { lcd.clearDisplay(); dashboard(lcd, "12:34:57"); }},
+    {"direct_redraw_batch", [](UC1609 &lcd) { dashboard(lcd, "12:34:56"); },
+      [](UC1609 &lcd) { UC1609Batch batch(lcd); lcd.clearDisplay(); dashboard(lcd, "12:34:57"); }},
+    {"text_refresh_full", [](UC1609 &lcd) { textBuffer.reset(); lcd.setTextBuffer(&textBuffer); },
+      [](UC1609 &lcd) { textScreen(lcd, "12:34:56"); lcd.refresh(); }},
+    {"text_refresh_update", [](UC1609 &lcd) {
+        textBuffer.reset(); lcd.setTextBuffer(&textBuffer); textScreen(lcd, "12:34:56"); lcd.refresh(); },
+      [](UC1609 &lcd) { textScreen(lcd, "12:35:07"); lcd.refresh(); }},
+    {"text_refresh_clear", [](UC1609 &lcd) {
+        textBuffer.reset(); lcd.setTextBuffer(&textBuffer); textScreen(lcd, "12:34:56"); lcd.refresh(); },
+      [](UC1609 &lcd) { textBuffer.clear(); lcd.setCursor(0, 2); lcd.print("Time:   12:35:07"); lcd.refresh(); }},
+    {"text_refresh_fb", [](UC1609 &lcd) {
+        lcd.setFrameBuffer(&frameBuffer); textBuffer.reset(); lcd.setTextBuffer(&textBuffer);
+        textScreen(lcd, "12:34:56"); lcd.refresh(); lcd.flush(); },
+      [](UC1609 &lcd) { textScreen(lcd, "12:35:07"); lcd.refresh(); lcd.flush(); }},
+    {"queue_tick_200us", noSetup, [](UC1609 &lcd) {
+        UC1609DrawQueue queue(lcd, queueOps, 12); queuedScreen(queue); queue.service(200); }},
+    {"queue_drain", noSetup, [](UC1609 &lcd) {
+        UC1609DrawQueue queue(lcd, queueOps, 12); queuedScreen(queue); while (!queue.isEmpty()) queue.service(200); }},
+    {"channel_dispatch", noSetup, [](UC1609 &lcd) {
+        UC1609Channel channel(channelSlots, 8);
+        channel.postText(0, 0, "wifi: connected");
+        channel.postText(0, 2, "sensor: 24.8c");
+        channel.postImage(168, 40, 24, 24, humidityIcon);
+        channel.postCommand(MESSAGE_CONTRAST, 0x40);
+        channel.dispatch(lcd); }},
+    {"log_line_clear", [](UC1609 &lcd) { for (int i = 0; i < 7; i++) lcd.println(i); lcd.print("event 7"); },
+      [](UC1609 &lcd) { lcd.println(); lcd.print("event 8"); }},
+    {"log_line_console", [](UC1609 &lcd) {
+        lcd.setConsoleMode(true); for (int i = 0; i < 7; i++) lcd.println(i); lcd.print("event 7"); },
+      [](UC1609 &lcd) { lcd.println(); lcd.print("event 8"); }},
+    {"log_console_wrap", [](UC1609 &lcd) { lcd.setConsoleMode(true); },
+      [](UC1609 &lcd) { for (int i = 0; i < 20; i++) { lcd.print("event "); lcd.println(i); } lcd.print("> "); }},
+    {"log_console_2x", [](UC1609 &lcd) { lcd.setConsoleMode(true); lcd.setFontScale(2); },
+      [](UC1609 &lcd) { for (int i = 0; i < 6; i++) { lcd.print("line "); lcd.println(i); } lcd.print("> "); }},
+    {"log_console_fb", [](UC1609 &lcd) { lcd.setConsoleMode(true); lcd.setFrameBuffer(&frameBuffer); },
+      [](UC1609 &lcd) { for (int i = 0; i < 11; i++) { lcd.print("event "); lcd.println(i); } lcd.print("> "); lcd.flush(); }},
+    {"scroll", [](UC1609 &lcd) { lcd.drawImage(0, 0, 192, 64, bitmap); }, [](UC1609 &lcd) { lcd.scroll(16); }},
+    {"rotate", [](UC1609 &lcd) { lcd.print("upside down"); }, [](UC1609 &lcd) { lcd.rotate(ROTATE_UPSIDE_DOWN); }},
+    {"invert", [](UC1609 &lcd) { lcd.print("inverted"); }, [](UC1609 &lcd) { lcd.invert(true); }},
+    {"settings_direct", [](UC1609 &lcd) { lcd.print("settings"); }, [](UC1609 &lcd) {
+        lcd.setContrast(0x60); lcd.rotate(ROTATE_UPSIDE_DOWN); lcd.invert(true); lcd.scroll(8); }},
+    {"settings_commit", [](UC1609 &lcd) { lcd.print("settings"); }, [](UC1609 &lcd) {
+        lcd.beginCommands(); lcd.setContrast(0x60); lcd.rotate(ROTATE_UPSIDE_DOWN); lcd.invert(true); lcd.scroll(8);
+        lcd.commit(); }},
+    {"settings_with_data", [](UC1609 &lcd) { lcd.print("settings"); }, [](UC1609 &lcd) {
+        lcd.beginCommands(); lcd.invert(true); lcd.setFrameRate(FRAME_RATE_132); lcd.print(" on"); lcd.commit(); }},
+    {"rotate_unchanged", [](UC1609 &lcd) { lcd.print("upright"); }, [](UC1609 &lcd) { lcd.rotate(NORMAL_ORIENTATION); }},
+    {"print_label_value", noSetup, [](UC1609 &lcd) {
+        for (int i = 0; i < 8; i++) { lcd.setCursor(0, i); lcd.print("Value "); lcd.setCursor(48, i); lcd.print(i * 125); } }},
+  };
+}
+
+/*
+ * Render every glyph of a font at scale 2 with the runtime stretch/anti-aliasing and with
+ * a pre-stretched table, return the number of glyphs whose display RAM differs.
+ */
+static int compareDoubleSize(const uint8_t *font, const uint8_t *table, bool antiAliasing) {
+  UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+  lcd.begin();
+  lcd.setFont(font);
+  lcd.setFontScale(2);
+  lcd.setAntiAliasing(antiAliasing);
+
+  int mismatches = 0;
+  for (int ch = font[2]; ch <= font[3]; ch++) {
+    if (ch == '\r' || ch == '\n' || ch == '\t' || ch == '\b') continue;
+    uint8_t c = ch;
+    lcd.setDoubleSizeFont(nullptr);
+    lcd.setCursor(0, 0);
+    lcd.write(c);
+    lcd.setDoubleSizeFont(table);
+    lcd.setCursor(12, 0);
+    lcd.write(c);
+    for (uint8_t col = 0; col < 12; col++) {
+      if (emu.ram(0, col) != emu.ram(0, col + 12) || emu.ram(1, col) != emu.ram(1, col + 12)) {
+        mismatches++;
+        break;
+      }
+    }
+  }
+  return mismatches;
+}
+
+static int checkDoubleSizeTables() {
+  struct { const char *name; const uint8_t *font; const uint8_t *aa; const uint8_t *noaa; } fonts[] = {
+    {"font5x7_numeric", font5x7_numeric, UC1609_DOUBLE_SIZE(font5x7_numeric), UC1609_DOUBLE_SIZE_NOAA(font5x7_numeric)},
+    {"font5x7", font5x7, UC1609_DOUBLE_SIZE(font5x7), UC1609_DOUBLE_SIZE_NOAA(font5x7)},
+    {"font5x7_symbol", font5x7_symbol, UC1609_DOUBLE_SIZE(font5x7_symbol), UC1609_DOUBLE_SIZE_NOAA(font5x7_symbol)},
+    {"font5x7_extended", font5x7_extended, UC1609_DOUBLE_SIZE(font5x7_extended), UC1609_DOUBLE_SIZE_NOAA(font5x7_extended)},
+  };
+  int failures = 0;
+  for (auto &f : fonts) {
+    int aa = compareDoubleSize(f.font, f.aa, true);
+    int noaa = compareDoubleSize(f.font, f.noaa, false);
+    printf("double-size table %-18s %s\n", f.name, (aa || noaa) ? "MISMATCH" : "identical to runtime");
+    if (aa || noaa) failures++;
+  }
+  return failures;
+}
+
+/*
+ * Print the same readout repeatedly through a glyph cache and compare the display RAM
+ * with an uncached run, report the hit rate.
+ */
+static int checkGlyphCache() {
+  static const char *readouts[] = {"12.5 kPa", "12.7 kPa", "13.1 kPa", "12.9 kPa"};
+  UC1609GlyphCacheEntry entries[8];
+  UC1609GlyphCache cache(entries, 8);
+  uint8_t plain[2][UC1609_COLUMNS];
+
+  int failures = 0;
+  for (int cached = 0; cached < 2; cached++) {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFontScale(2);
+    if (cached) lcd.setGlyphCache(&cache);
+    for (int i = 0; i < 20; i++) {
+      lcd.setCursor(0, 0);
+      lcd.print(readouts[i % 4]);
+    }
+    for (uint8_t page = 0; page < 2; page++) {
+      for (uint8_t col = 0; col < UC1609_COLUMNS; col++) {
+        if (!cached) plain[page][col] = emu.ram(page, col);
+        else if (plain[page][col] != emu.ram(page, col)) failures = 1;
+      }
+    }
+  }
+  printf("glyph cache (8 entries)         %u hits, %u misses, %s\n", cache.hits(), cache.misses(),
+         failures ? "MISMATCH" : "identical to uncached");
+  return failures;
+}
+
+/*
+ * Scalar anti-aliasing (one pattern compare per bit pair), kept as the reference for the
+ * word-parallel UC1609::_antiAliasing(). It is the kernel as fixed along with the
+ * double-size font tables: the released one looped adjL < 22, reading past the 24-byte
+ * buffer and cutting off the corrections of the bottom page.
+ */
+static uint16_t referenceStretch(uint8_t x) {
+  uint16_t d = (uint16_t) x;
+  d = (d & 0xF0) << 4 | (d & 0x0F);
+  d = (d << 2 | d) & 0x3333;
+  d = (d << 1 | d) & 0x5555;
+  return d | d << 1;
+}
+
+static void referenceAntiAliasing(uint8_t *array) {
+  uint8_t temp[24];
+  memcpy(temp, array, 24);
+  for (int adjL = 2; adjL < 10; adjL += 2) {
+    uint16_t pattern1 = 0x000C;
+    uint16_t pattern2 = 0x0003;
+    uint16_t patternMask = 0x000F;
+    uint16_t bitAddedL = 0x0002;
+    uint16_t bitAddedR = 0x0004;
+    uint8_t adjR = adjL + 1;
+    uint16_t adjL16 = (uint16_t) array[adjL+12] << 8 | array[adjL];
+    uint16_t adjR16 = (uint16_t) array[adjR+12] << 8 | array[adjR];
+    uint16_t addedL = 0;
+    uint16_t addedR = 0;
+    for (int i = 0; i < 6; i++) {
+      if ((adjL16 & patternMask) == pattern1 && (adjR16 & patternMask) == pattern2) {
+        addedL |= bitAddedL;
+        addedR |= bitAddedR;
+      }
+      if ((adjL16 & patternMask) == pattern2 && (adjR16 & patternMask) == pattern1) {
+        addedL |= bitAddedR;
+        addedR |= bitAddedL;
+      }
+      pattern1 <<= 2;
+      pattern2 <<= 2;
+      patternMask <<= 2;
+      bitAddedL <<= 2;
+      bitAddedR <<= 2;
+    }
+    temp[adjL] |= addedL & 0xFF;
+    temp[adjL+12] |= addedL >> 8;
+    temp[adjR] |= addedR & 0xFF;
+    temp[adjR+12] |= addedR >> 8;
+  }
+  memcpy(array, temp, 24);
+}
+
+static void referenceDoubleSize(const uint8_t *font, uint8_t ch, uint8_t *buf) {
+  memset(buf, 0, 24);
+  for (uint8_t x = 0; x < 5; x++) {
+    uint16_t stretched = referenceStretch(font[4 + (ch - font[2]) * 5 + x]);
+    buf[x * 2 + 1] = buf[x * 2 + 2] = stretched & 0xFF;
+    buf[x * 2 + 13] = buf[x * 2 + 14] = stretched >> 8;
+  }
+  referenceAntiAliasing(buf);
+}
+
+/*
+ * Bench access to the private kernels of UC1609 (built with UC1609_BENCH).
+ */
+struct UC1609Bench {
+  static void antiAliasing(UC1609 &lcd, uint8_t *array) { lcd._antiAliasing(array); }
+};
+
+/*
+ * Render every glyph of font5x7_extended at scale 2 with anti-aliasing and compare the
+ * display RAM with the scalar reference. The timing shows both kernels on their own,
+ * over the same stretched glyphs, and a whole library 2x write with and without
+ * anti-aliasing.
+ */
+static int checkAntiAliasing() {
+  const uint8_t *font = font5x7_extended;
+  int mismatches = 0;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFont(font);
+    lcd.setFontScale(2);
+    for (int ch = font[2]; ch <= font[3]; ch++) {
+      if (ch == '\r' || ch == '\n' || ch == '\t' || ch == '\b') continue;
+      uint8_t expected[24];
+      referenceDoubleSize(font, ch, expected);
+      lcd.setCursor(0, 0);
+      lcd.write((uint8_t) ch);
+      for (uint8_t col = 0; col < 12; col++) {
+        if (emu.ram(0, col) != expected[col] || emu.ram(1, col) != expected[col + 12]) {
+          mismatches++;
+          break;
+        }
+      }
+    }
+  }
+  printf("anti-aliasing font5x7_extended  %d glyph(s) differ from scalar reference\n", mismatches);
+
+  const int rounds = 200000;
+  uint8_t stretched[10][24];
+  for (int d = 0; d < 10; d++) {
+    referenceDoubleSize(font, '0' + d, stretched[d]);
+  }
+  volatile uint8_t sink = 0;
+  UC1609 kernel(PIN_CS, PIN_CD, PIN_RST);
+  for (int word = 0; word < 2; word++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      uint8_t buf[24];
+      memcpy(buf, stretched[i % 10], 24);
+      if (word) UC1609Bench::antiAliasing(kernel, buf);
+      else referenceAntiAliasing(buf);
+      sink = sink + buf[5];
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+    printf("anti-aliasing cpu %-13s %7.1f ns/glyph (kernel only)\n", word ? "word-parallel" : "reference", ns);
+  }
+
+  for (int aa = 0; aa < 2; aa++) {
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFontScale(2);
+    lcd.setAntiAliasing(aa);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds / 10; i++) {
+      lcd.setCursor(0, 0);
+      lcd.print("0123456789");
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+    printf("anti-aliasing cpu library %-5s %7.1f ns/glyph (whole 2x write)\n", aa ? "on" : "off", ns);
+  }
+  return mismatches ? 1 : 0;
+}
+
+/*
+ * Host CPU time per scaled glyph with no device attached to the bus, i.e. the cost of
+ * stretching, smoothing and buffering a glyph rather than of sending it.
+ */
+static void timeScaledGlyphs() {
+  struct { const char *name; uint8_t scale; bool table; bool cache; } modes[] = {
+    {"2x runtime", 2, false, false},
+    {"2x table", 2, true, false},
+    {"2x cache", 2, false, true},
+    {"3x", 3, false, false},
+    {"4x", 4, false, false},
+  };
+  const int rounds = 2000;
+  UC1609GlyphCacheEntry entries[16];
+  UC1609GlyphCache cache(entries, 16);
+
+  for (auto &m : modes) {
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFontScale(m.scale);
+    if (m.table) lcd.setDoubleSizeFont(UC1609_DOUBLE_SIZE(font5x7));
+    if (m.cache) lcd.setGlyphCache(&cache);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      lcd.setCursor(0, 0);
+      lcd.print("0123");
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("glyph cpu %-21s %7.1f ns/glyph\n", m.name, ns / (rounds * 4));
+  }
+}
+
+/*
+ * Draw each compressed image at several positions, some of them clipped, and compare the
+ * display RAM with drawImage() of the uncompressed image.
+ */
+static int checkCompressedImages() {
+  struct { const uint8_t *image; const uint8_t *rle; uint8_t w, h; } images[] = {
+    {bitmap, bitmapRle, 192, 64},
+    {thermometerIcon, thermometerIconRle, 24, 24},
+    {humidityIcon, humidityIconRle, 24, 24},
+  };
+  const uint8_t positions[][2] = {{0, 0}, {70, 8}, {100, 16}, {180, 48}, {191, 56}};
+  int mismatches = 0;
+  uint32_t rawBytes = 0;
+  uint32_t rleBytes = 0;
+  for (auto &img : images) {
+    for (auto &pos : positions) {
+      UC1609Emulator emuRaw(PIN_CS, PIN_CD, PIN_RST);
+      UC1609 raw(PIN_CS, PIN_CD, PIN_RST);
+      raw.begin();
+      raw.drawImage(pos[0], pos[1], img.w, img.h, img.image);
+      UC1609Emulator emuRle(PIN_CS, PIN_CD, PIN_RST);
+      UC1609 rle(PIN_CS, PIN_CD, PIN_RST);
+      rle.begin();
+      rle.drawCompressedImage(pos[0], pos[1], img.rle);
+      for (uint8_t page = 0; page < UC1609_PAGES; page++) {
+        for (uint8_t col = 0; col < UC1609_COLUMNS; col++) {
+          if (emuRaw.ram(page, col) != emuRle.ram(page, col)) mismatches++;
+        }
+      }
+    }
+  }
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    emu.resetStats();
+    lcd.drawCompressedImage(0, 0, nullptr);
+    if (emu.stats().bytes) mismatches++;
+  }
+  rawBytes = sizeof(bitmap) + sizeof(thermometerIcon) + sizeof(humidityIcon);
+  rleBytes = sizeof(bitmapRle) + sizeof(thermometerIconRle) + sizeof(humidityIconRle);
+  printf("compressed images               %s, %u bytes of flash instead of %u\n",
+         mismatches ? "MISMATCH" : "identical to drawImage()", rleBytes, rawBytes);
+  return mismatches ? 1 : 0;
+}
+
+/*
+ * Play the looping animation twice, the display must be the same at the same frame of
+ * both loops and back to the keyframe after each loop. Report the bytes per frame.
+ */
+static int checkAnimation() {
+  UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+  UC1609Animation player(lcd);
+  lcd.begin();
+  player.begin(bootAnimation, 48, 8, 100, true);
+  uint8_t count = player.frames();
+  std::vector<std::vector<uint8_t>> screens;
+  int mismatches = 0;
+  emu.resetStats();
+  for (int i = 0; i <= 2 * count; i++) {
+    std::vector<uint8_t> screen;
+    for (uint8_t page = 0; page < UC1609_PAGES; page++)
+      for (uint8_t col = 0; col < UC1609_COLUMNS; col++) screen.push_back(emu.ram(page, col));
+    if (i < count) screens.push_back(screen);
+    else if (screen != screens[i % count] || player.frame() != i % count) mismatches++;
+    if (i < 2 * count) player.drawFrame();
+  }
+  uint32_t bytes = emu.stats().bytes;
+  printf("animation %u frames               %s, %.1f bytes/frame instead of %u\n", count,
+         mismatches ? "MISMATCH" : "loops back to the keyframe", (double) bytes / (2 * count),
+         (unsigned) (readFontByte(bootAnimation[0]) * (readFontByte(bootAnimation[1]) / 8)));
+  return mismatches ? 1 : 0;
+}
+
+static std::vector<uint8_t> displayRam(const UC1609Emulator &emu) {
+  std::vector<uint8_t> ram;
+  for (uint8_t page = 0; page < UC1609_PAGES; page++)
+    for (uint8_t col = 0; col < UC1609_COLUMNS; col++) ram.push_back(emu.ram(page, col));
+  return ram;
+}
+
+static int completions = 0;
+static void countCompletion(UC1609 &lcd) { (void) lcd; completions++; }
+
+static void secondFrame(UC1609 &lcd) {
+  dashboard(lcd, "12:34:57");
+  lcd.drawImage(0, 40, 24, 24, thermometerIcon);
+}
+
+/*
+ * flushAsync() must leave the display as flush() does. Polled: nothing is sent before
+ * service(), each service() step stays within its budget and the callback runs once at
+ * the end. Double-buffered with the simulated DMA back-end: a frame drawn during the
+ * transfer does not leak into it, and a command issued while busy waits for completion.
+ */
+static int checkAsyncFlush() {
+  std::vector<uint8_t> frameA, frameB;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFrameBuffer(&frameBuffer);
+    dashboard(lcd, "12:34:56");
+    lcd.flush();
+    frameA = displayRam(emu);
+    secondFrame(lcd);
+    lcd.flush();
+    frameB = displayRam(emu);
+  }
+
+  int steps = 0;
+  bool polled;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFrameBuffer(&frameBuffer);
+    polled = !lcd.flushAsync();          // no state attached
+    lcd.setAsyncState(&asyncState);
+    dashboard(lcd, "12:34:56");
+    completions = 0;
+    emu.resetStats();
+    polled = polled && lcd.flushAsync(countCompletion) && lcd.isBusy() && emu.stats().bytes == 0 && !lcd.flushAsync();
+    while (lcd.isBusy()) {
+      uint32_t before = emu.stats().dataBytes;
+      lcd.service(32);
+      polled = polled && emu.stats().dataBytes - before <= 32 && (completions == 0) == lcd.isBusy();
+      steps++;
+    }
+    polled = polled && completions == 1 && displayRam(emu) == frameA;
+  }
+  printf("flushAsync polled               %s, %d service() steps of 32 bytes\n",
+         polled ? "same as flush()" : "WRONG", steps);
+
+  bool dma;
+  uint32_t starts;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    SimDma sim(lcd);
+    lcd.begin();
+    lcd.setFrameBuffer(&frameBuffer);
+    lcd.setAsyncState(&asyncState);
+    lcd.setBackBuffer(&backBuffer);
+    lcd.setAsyncBackend(&sim);
+    dashboard(lcd, "12:34:56");
+    completions = 0;
+    dma = lcd.flushAsync(countCompletion);
+    secondFrame(lcd);                    // drawn into the back buffer during the transfer
+    while (lcd.isBusy()) {
+      sim.tick(16);
+      lcd.service();
+    }
+    dma = dma && completions == 1 && displayRam(emu) == frameA;
+    dma = dma && lcd.flushAsync(countCompletion) && lcd.isBusy();
+    lcd.setContrast(0x30);               // waits for the transfer
+    dma = dma && !lcd.isBusy() && completions == 2 && displayRam(emu) == frameB && emu.vbias() == 0x30;
+    starts = sim.starts;
+    lcd.setAsyncBackend(nullptr);
+  }
+  printf("flushAsync DMA double-buffered  %s, %u bursts\n", dma ? "frames in order" : "WRONG", starts);
+  return (polled ? 0 : 1) + (dma ? 0 : 1);
+}
+
+static const char scaledText[] = "Scale 2 text, costed per glyph\nline 2\nline 3\ncleared";
+
+/*
+ * Text at font scale 2 drawn in service(200) ticks: each tick stays within its budget,
+ * except the one tick that clears the screen when the text runs past the last line, which
+ * draws nothing else.
+ */
+static int checkDrawQueueScaled() {
+  std::vector<uint8_t> direct;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFontScale(2);
+    lcd.print(scaledText);
+    direct = displayRam(emu);
+  }
+
+  UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+  UC1609DrawOp ops[12];
+  UC1609DrawQueue queue(lcd, ops, 12);
+  lcd.begin();
+  lcd.setFontScale(2);
+  queue.text(0, 0, scaledText);
+  int ticks = 0, clears = 0;
+  double worst = 0;
+  while (!queue.isEmpty()) {
+    UC1609WireStats before = emu.stats();
+    queue.service(200);
+    double us = (emu.stats().wireNanos - before.wireNanos) / 1000.0;
+    if (emu.stats().dataBytes - before.dataBytes >= 1536) clears++;
+    else if (us > worst) worst = us;
+    ticks++;
+  }
+  bool ok = displayRam(emu) == direct && clears == 1 && worst <= 200;
+  printf("draw queue text at scale 2      %s, %d ticks, longest %.1fus, %d clear tick\n",
+         ok ? "same as direct" : "WRONG", ticks, worst, clears);
+  return ok ? 0 : 1;
+}
+
+/*
+ * A screen drawn through UC1609DrawQueue in service(200) ticks must equal the same calls
+ * made directly. Each tick stays within its budget, data and address commands included,
+ * partly drawn operations resume where they stopped, and the high-water mark reports the
+ * deepest queue.
+ */
+static int checkDrawQueue() {
+  std::vector<uint8_t> direct;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.clearDisplay();
+    lcd.setCursor(0, 0);
+    lcd.print("Queued drawing, 200us per tick");
+    lcd.setCursor(0, 2);
+    lcd.print("Temp:");
+    lcd.drawImage(48, 32, 24, 24, thermometerIcon);
+    lcd.fillRect(96, 4, 96, 3, 0x55);
+    lcd.invert(true);
+    direct = displayRam(emu);
+  }
+
+  UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+  UC1609DrawOp ops[12];
+  UC1609DrawQueue queue(lcd, ops, 12);
+  lcd.begin();
+  queuedScreen(queue);
+  bool ok = queue.depth() == 9 && queue.highWater() == 9 && !queue.text(0, 7, "does not fit in the 3 free entries");
+  int ticks = 0;
+  double worst = 0;
+  while (!queue.isEmpty()) {
+    uint64_t before = emu.stats().wireNanos;
+    queue.service(200);
+    double us = (emu.stats().wireNanos - before) / 1000.0;
+    if (us > worst) worst = us;
+    ticks++;
+  }
+  ok = ok && displayRam(emu) == direct && emu.inverse() && queue.service(200) == 0;
+  ok = ok && worst <= 200;
+  printf("draw queue service(200)         %s, %d ticks, longest %.1fus\n",
+         ok ? "same as direct" : "WRONG", ticks, worst);
+  return (ok ? 0 : 1) + checkDrawQueueScaled();
+}
+
+/*
+ * Producers post numbered messages from std::threads while a consumer thread takes them.
+ * Every message taken must be the next one of its producer, or a later one where the
+ * policy dropped some, and taken + dropped + overwritten must add up to what was posted.
+ */
+struct ChannelRun {
+  uint32_t taken;
+  uint32_t outOfOrder;
+};
+
+static ChannelRun runChannel(UC1609Channel &channel, int producers, uint32_t perProducer, bool lossless) {
+  std::vector<uint32_t> next(producers, 0);
+  ChannelRun run = {0, 0};
+  volatile bool done = false;
+  std::thread consumer([&] {
+    UC1609Message msg;
+    for (;;) {
+      bool finished = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+      if (!channel.receive(msg)) {
+        if (finished) break;
+        std::this_thread::yield();
+        continue;
+      }
+      uint32_t seq;
+      memcpy(&seq, msg.text, sizeof(seq));
+      if (msg.x >= producers || seq < next[msg.x] || (lossless && seq != next[msg.x])) run.outOfOrder++;
+      else next[msg.x] = seq + 1;
+      run.taken++;
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([&channel, p, perProducer] {
+      UC1609Message msg;
+      msg.type = MESSAGE_TEXT;
+      msg.x = p;
+      for (uint32_t seq = 0; seq < perProducer; seq++) {
+        memcpy(msg.text, &seq, sizeof(seq));
+        channel.post(msg);
+      }
+    });
+  }
+  for (std::thread &t : threads) t.join();
+  __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+  consumer.join();
+  return run;
+}
+
+/*
+ * Tasks printing their own line through the channel, with a thread owning the display,
+ * must leave the screen as printing the last text of each line directly.
+ */
+static int checkChannel() {
+  const uint32_t count = 50000;
+  int failures = 0;
+  hostYieldHook = [] { std::this_thread::yield(); };   // CHANNEL_BLOCK waits with yield()
+
+  UC1609ChannelSlot slots[16];
+  {
+    UC1609Channel channel(slots, 16, CHANNEL_BLOCK, true);
+    ChannelRun run = runChannel(channel, 4, count, true);
+    bool ok = run.taken == 4 * count && run.outOfOrder == 0;
+    printf("channel MPMC block 4 threads    %s, %u messages\n", ok ? "all in order" : "WRONG", run.taken);
+    failures += ok ? 0 : 1;
+  }
+  {
+    UC1609Channel channel(slots, 16, CHANNEL_DROP, false);
+    ChannelRun run = runChannel(channel, 1, count, false);
+    bool ok = run.taken + channel.dropped() == count && run.outOfOrder == 0;
+    printf("channel SPSC drop               %s, %u taken, %u dropped\n",
+           ok ? "in order" : "WRONG", run.taken, channel.dropped());
+    failures += ok ? 0 : 1;
+  }
+  {
+    UC1609Channel channel(slots, 16, CHANNEL_OVERWRITE, true);
+    ChannelRun run = runChannel(channel, 4, count, false);
+    bool ok = run.taken + channel.overwritten() + channel.dropped() == 4 * count && run.outOfOrder == 0;
+    printf("channel MPMC overwrite          %s, %u taken, %u overwritten, %u dropped\n",
+           ok ? "in order" : "WRONG", run.taken, channel.overwritten(), channel.dropped());
+    failures += ok ? 0 : 1;
+  }
+  {
+    UC1609Channel none(nullptr, 16, CHANNEL_BLOCK);
+    UC1609Channel one(slots, 1, CHANNEL_OVERWRITE);
+    UC1609Channel three(slots, 3);
+    UC1609Message msg;
+    bool ok = none.capacity() == 0 && one.capacity() == 0 && three.capacity() == 2;
+    ok = ok && !none.postCommand(MESSAGE_FLUSH) && !one.postCommand(MESSAGE_FLUSH) && !one.receive(msg);
+    ok = ok && none.dropped() == 1 && one.dropped() == 1;
+    printf("channel capacity below 2        %s\n", ok ? "rejected, posts fail" : "WRONG");
+    failures += ok ? 0 : 1;
+  }
+  {
+    // an ISR posting while it preempted the owner inside receive(), after its
+    // compare-and-swap on the read position and before it published slot 0 again
+    UC1609Channel channel(slots, 2, CHANNEL_OVERWRITE);
+    UC1609Message msg;
+    channel.postCommand(MESSAGE_FLUSH);
+    channel.postCommand(MESSAGE_FLUSH);
+    channel.receive(msg);
+    slots[0].seq = 1;
+    bool ok = !channel.postCommand(MESSAGE_FLUSH) && channel.overwritten() == 1 && channel.dropped() == 1;
+    slots[0].seq = 2;                    // the owner resumes and publishes the slot
+    ok = ok && channel.postCommand(MESSAGE_FLUSH) && channel.receive(msg) && !channel.receive(msg);
+    printf("channel overwrite preempted     %s\n", ok ? "request dropped, no spin" : "WRONG");
+    failures += ok ? 0 : 1;
+  }
+
+  std::vector<uint8_t> direct;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    for (int t = 0; t < 4; t++) {
+      lcd.setCursor(0, t * 2);
+      lcd.print("task ");
+      lcd.print(t);
+      lcd.print(": 999");
+    }
+    direct = displayRam(emu);
+  }
+  UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+  lcd.begin();
+  UC1609Channel channel(slots, 16, CHANNEL_BLOCK, true);
+  volatile bool done = false;
+  uint32_t dispatched = 0;
+  std::thread owner([&] {
+    for (;;) {
+      bool finished = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+      uint8_t n = channel.dispatch(lcd, 8);
+      dispatched += n;
+      if (!n && finished) break;
+    }
+  });
+  std::vector<std::thread> tasks;
+  for (int t = 0; t < 4; t++) {
+    tasks.emplace_back([&channel, t] {
+      char text[UC1609_MESSAGE_TEXT];
+      for (int i = 0; i < 1000; i++) {
+        snprintf(text, sizeof(text), "task %d: %3d", t, i);
+        channel.postText(0, t * 2, text);
+      }
+    });
+  }
+  for (std::thread &t : tasks) t.join();
+  __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+  owner.join();
+  hostYieldHook = nullptr;
+  bool ok = dispatched == 4000 && displayRam(emu) == direct;
+  printf("channel display owner 4 tasks   %s, %u requests\n", ok ? "no interleaving" : "WRONG", dispatched);
+  return failures + (ok ? 0 : 1);
+}
+
+/*
+ * Several device models on one SPI bus: bytes, pin writes and transactions go to all of
+ * them, each panel only listens while its CS pin is low. It also plays a foreign device
+ * (CS on SENSOR_CS, 1MHz) and checks the wire rules of a shared bus: no nested
+ * transactions, no bytes outside one, one CS low at a time, and each device clocked at
+ * its own speed.
+ */
+#define SENSOR_CS 5
+
+class SharedBus: public HostBus {
+  public:
+    SharedBus(std::vector<UC1609Emulator *> panels): _panels(panels) { hostAttachBus(this); }
+    ~SharedBus() { hostAttachBus(nullptr); }
+
+    uint32_t sensorBytes{0};
+    uint32_t violations{0};
+    uint32_t clocks[3]{SPI_CLOCK, SPI_CLOCK, SPI_CLOCK};    // of the panels on PIN_CS + i
+
+    void pinWrite(uint8_t pin, uint8_t level) override {
+      if (pin == SENSOR_CS || pin == PIN_CS || pin == PIN_CS + 1 || pin == PIN_CS + 2) {
+        if (level) _low &= ~(1u << pin);
+        else _low |= 1u << pin;
+        if (_low & (_low - 1)) violations++;
+      }
+      for (UC1609Emulator *panel : _panels) panel->pinWrite(pin, level);
+    }
+    void beginTransaction(uint32_t clock) override {
+      if (_open) violations++;
+      _open = true;
+      _clock = clock;
+      for (UC1609Emulator *panel : _panels) panel->beginTransaction(clock);
+    }
+    void endTransaction() override {
+      if (!_open) violations++;
+      _open = false;
+    }
+    uint8_t transfer(uint8_t data) override {
+      if (!_open) violations++;
+      if (_low & (1u << SENSOR_CS)) {
+        if (_clock != 1000000UL) violations++;
+        sensorBytes++;
+      }
+      else {
+        for (uint8_t i = 0; i < 3; i++) {
+          if ((_low & (1u << (PIN_CS + i))) && _clock != clocks[i]) violations++;
+        }
+      }
+      for (UC1609Emulator *panel : _panels) panel->transfer(data);
+      return 0;
+    }
+
+  private:
+    std::vector<UC1609Emulator *> _panels;
+    uint32_t _low{0};
+    uint32_t _clock{0};
+    bool _open{false};
+};
+
+class Sensor: public UC1609BusDevice {
+  public:
+    Sensor(UC1609Bus &bus): UC1609BusDevice(bus, 2, 1000000UL, MSBFIRST, SPI_MODE3) {}
+    uint8_t reads{0};
+    bool pending() override { return reads > 0; }
+    uint16_t transfer(uint16_t maxBytes) override {
+      (void) maxBytes;
+      digitalWrite(SENSOR_CS, LOW);
+      for (uint8_t i = 0; i < 6; i++) SPI.transfer(0x00);
+      digitalWrite(SENSOR_CS, HIGH);
+      reads--;
+      return 6;
+    }
+};
+
+static UC1609FrameBuffer panelBuffers[2];
+static UC1609DrawOp panelOps[12];
+
+static void panelScreens(UC1609 &a, UC1609 &b, UC1609DrawQueue &c) {
+  dashboard(a, "12:34:56");
+  b.drawImage(0, 0, 192, 64, bitmap);
+  b.setCursor(0, 7);
+  b.print("panel B");
+  queuedScreen(c);
+}
+
+/*
+ * Three panels and a sensor served by UC1609Bus must leave each panel as drawing it
+ * alone does, with the sensor (highest priority) served first and the two panels of
+ * equal priority taking turns.
+ */
+static int checkSharedBus() {
+  std::vector<std::vector<uint8_t>> reference;
+  for (int i = 0; i < 3; i++) {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    UC1609DrawQueue queue(lcd, panelOps, 12);
+    if (i == 0) dashboard(lcd, "12:34:56");
+    if (i == 1) {
+      lcd.drawImage(0, 0, 192, 64, bitmap);
+      lcd.setCursor(0, 7);
+      lcd.print("panel B");
+    }
+    if (i == 2) {
+      queuedScreen(queue);
+      while (!queue.isEmpty()) queue.service(1000);
+    }
+    reference.push_back(displayRam(emu));
+  }
+
+  UC1609Emulator emuA(PIN_CS, PIN_CD, PIN_RST);
+  UC1609Emulator emuB(PIN_CS + 1, PIN_CD, PIN_RST - 1);
+  UC1609Emulator emuC(PIN_CS + 2, PIN_CD, PIN_RST - 2);
+  SharedBus wire({&emuA, &emuB, &emuC});
+  UC1609 lcdA(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcdB(PIN_CS + 1, PIN_CD, PIN_RST - 1);
+  UC1609 lcdC(PIN_CS + 2, PIN_CD, PIN_RST - 2);
+  pinMode(SENSOR_CS, OUTPUT);
+  digitalWrite(SENSOR_CS, HIGH);
+  UC1609DrawQueue queue(lcdC, panelOps, 12);
+  UC1609Bus bus;
+  UC1609BusPanel panelA(bus, lcdA, 0);
+  UC1609BusPanel panelB(bus, lcdB, 0);
+  UC1609BusPanel panelC(bus, lcdC, 1, &queue);
+  Sensor sensor(bus);
+  lcdA.begin();
+  lcdB.begin();
+  lcdC.begin();
+  lcdA.setFrameBuffer(&panelBuffers[0]);
+  lcdB.setFrameBuffer(&panelBuffers[1]);
+  panelScreens(lcdA, lcdB, queue);
+  sensor.reads = 4;
+  uint32_t before = bus.transactions();
+  emuA.resetStats();
+  emuB.resetStats();
+
+  bool ok = true;
+  bus.service(64, 4);
+  ok = ok && sensor.reads == 0 && sensor.slots() == 4 && panelA.slots() == 0 && panelB.slots() == 0;
+  ok = ok && bus.transactions() - before == 1;
+  bus.service(64, 1);
+  ok = ok && panelC.slots() == 1;      // priority 1 before the panels of priority 0
+  while (panelC.pending()) bus.service(64, 1);
+  ok = ok && panelA.slots() == 0 && panelB.slots() == 0;
+  bus.service(64, 2);
+  ok = ok && panelA.slots() == 1 && panelB.slots() == 1;     // equal priority, turns
+  while (bus.service(64)) {}
+  ok = ok && !panelA.pending() && !panelB.pending() && !panelC.pending();
+  ok = ok && displayRam(emuA) == reference[0] && displayRam(emuB) == reference[1] && displayRam(emuC) == reference[2];
+  ok = ok && wire.violations == 0 && wire.sensorBytes == sensor.bytes();
+  ok = ok && panelA.bytes() == emuA.stats().dataBytes && panelB.bytes() == emuB.stats().dataBytes;
+  printf("shared bus 3 panels + sensor    %s, %u transactions for %u slots\n", ok ? "same as alone" : "WRONG",
+         bus.transactions() - before, panelA.slots() + panelB.slots() + panelC.slots() + sensor.slots());
+  UC1609BusDevice *devices[] = {&panelA, &panelB, &panelC, &sensor};
+  const char *names[] = {"panel A fb", "panel B fb", "panel C queue", "sensor 1MHz"};
+  for (int i = 0; i < 4; i++) {
+    printf("  %-14s prio %u %4u slots %6u bytes %8.1f kB/s\n", names[i], devices[i]->priority(),
+           devices[i]->slots(), devices[i]->bytes(), devices[i]->bytesPerSecond() / 1000.0);
+  }
+
+  // a device destroyed or detached with work pending is no longer served
+  {
+    Sensor gone(bus);
+    gone.reads = 1;
+  }
+  sensor.detach();
+  sensor.reads = 1;
+  panelB.detach();
+  lcdB.setCursor(0, 6);
+  lcdB.print("detached");
+  bool detached = bus.service(64) == 0 && sensor.reads == 1 && panelB.pending();
+  sensor.reads = 0;
+  printf("shared bus detach               %s\n", detached ? "devices no longer served" : "WRONG");
+  lcdA.setFrameBuffer(nullptr);
+  lcdB.setFrameBuffer(nullptr);
+  return (ok ? 0 : 1) + (detached ? 0 : 1);
+}
+
+/*
+ * A panel flushed by SimDma and a panel on a second SPIClass at 4MHz share the bus with
+ * the sensor: the DMA burst must keep the transaction, the sensor waiting for it, and the
+ * second panel must be clocked by its own transport.
+ */
+static int checkSharedBusBackends() {
+  std::vector<std::vector<uint8_t>> reference;
+  for (int i = 0; i < 2; i++) {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    if (i == 0) dashboard(lcd, "12:34:56");
+    if (i == 1) {
+      lcd.drawImage(0, 0, 192, 64, bitmap);
+      lcd.setCursor(0, 7);
+      lcd.print("panel B");
+    }
+    reference.push_back(displayRam(emu));
+  }
+
+  UC1609Emulator emuA(PIN_CS, PIN_CD, PIN_RST);
+  UC1609Emulator emuB(PIN_CS + 1, PIN_CD, PIN_RST - 1);
+  SharedBus wire({&emuA, &emuB});
+  wire.clocks[1] = 4000000UL;
+  UC1609 lcdA(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcdB(PIN_CS + 1, PIN_CD, PIN_RST - 1);
+  SPIClass spi1;
+  UC1609SpiTransport transport(spi1, 4000000UL);
+  lcdB.setTransport(&transport);
+  pinMode(SENSOR_CS, OUTPUT);
+  digitalWrite(SENSOR_CS, HIGH);
+  UC1609Bus bus;
+  UC1609BusPanel panelA(bus, lcdA, 0);
+  UC1609BusPanel panelB(bus, lcdB, 0);
+  Sensor sensor(bus);
+  lcdA.begin();
+  lcdB.begin();
+  SimDma dma(lcdA);
+  lcdA.setAsyncBackend(&dma);
+  lcdA.setFrameBuffer(&panelBuffers[0]);
+  lcdB.setFrameBuffer(&panelBuffers[1]);
+  dashboard(lcdA, "12:34:56");
+  lcdB.drawImage(0, 0, 192, 64, bitmap);
+  lcdB.setCursor(0, 7);
+  lcdB.print("panel B");
+
+  bool ok = true;
+  bus.service(64, 1);
+  ok = ok && panelA.slots() == 1 && lcdA.isBusClaimed();     // DMA burst in flight
+  sensor.reads = 2;
+  bus.service(64, 1);
+  ok = ok && sensor.slots() == 0 && panelA.slots() == 2;      // the burst keeps the bus
+  while (panelA.pending() || panelB.pending() || sensor.pending()) {
+    bus.service(64);
+    yield();
+  }
+  ok = ok && sensor.reads == 0 && dma.starts > 0;
+  ok = ok && displayRam(emuA) == reference[0] && displayRam(emuB) == reference[1];
+  ok = ok && wire.violations == 0 && wire.sensorBytes == sensor.bytes();
+  printf("shared bus DMA + SPIClass 4MHz  %s, %u DMA bursts, %u violations\n",
+         ok ? "same as alone" : "WRONG", dma.starts, wire.violations);
+  lcdA.setAsyncBackend(nullptr);
+  lcdA.setFrameBuffer(nullptr);
+  lcdB.setFrameBuffer(nullptr);
+  return ok ? 0 : 1;
+}
+
+/*
+ * Decodes bit-banged SCK/MOSI pin writes (SPI mode 0, MSB first) into bytes for the
+ * emulator, which otherwise only sees SPI.transfer().
+ */
+#define PIN_SCK  13
+#define PIN_MOSI 11
+
+class BitBangWire: public HostBus {
+  public:
+    BitBangWire(UC1609Emulator &emu): _emu(emu) { hostAttachBus(this); }
+    ~BitBangWire() { hostAttachBus(nullptr); }
+
+    void pinWrite(uint8_t pin, uint8_t level) override {
+      if (pin == PIN_MOSI) {
+        _mosi = level;
+      }
+      else if (pin == PIN_SCK) {
+        if (level && !_sck) {
+          _shift = (_shift << 1) | _mosi;
+          if (++_bits == 8) {
+            _emu.transfer(_shift);
+            _bits = 0;
+          }
+        }
+        _sck = level;
+      }
+      else {
+        _emu.pinWrite(pin, level);
+      }
+    }
+
+  private:
+    UC1609Emulator &_emu;
+    uint8_t _sck{0}, _mosi{0}, _shift{0}, _bits{0};
+};
+
+static void transportScreen(UC1609 &lcd) {
+  dashboard(lcd, "12:34:56");
+  lcd.drawImage(168, 40, 24, 24, humidityIcon);
+  lcd.setContrast(0x40);
+}
+
+/*
+ * Replay the records of a UC1609CaptureTransport into an emulator.
+ */
+static void replayCapture(UC1609Emulator &emu, const UC1609CaptureTransport &capture) {
+  const uint8_t *p = capture.records();
+  const uint8_t *end = p + capture.length();
+  emu.pinWrite(PIN_CS, LOW);
+  while (p < end) {
+    emu.pinWrite(PIN_CD, p[0] == CAPTURE_DATA ? HIGH : LOW);
+    for (uint8_t i = 0; i < p[1]; i++) emu.transfer(p[2 + i]);
+    p += 2 + p[1];
+  }
+  emu.pinWrite(PIN_CS, HIGH);
+}
+
+/*
+ * The same screen through the default path, a second SPIClass at 4MHz, the bit-banged
+ * transport and a capture replayed into an emulator must leave the same display RAM.
+ */
+static int checkTransports() {
+  std::vector<uint8_t> reference;
+  uint64_t referenceNanos;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    emu.resetStats();
+    transportScreen(lcd);
+    reference = displayRam(emu);
+    referenceNanos = emu.stats().wireNanos;
+  }
+
+  bool spi;
+  uint64_t spiNanos;
+  {
+    SPIClass spi1;
+    UC1609SpiTransport transport(spi1, 4000000UL);
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.setTransport(&transport);
+    lcd.begin();
+    emu.resetStats();
+    transportScreen(lcd);
+    spiNanos = emu.stats().wireNanos;
+    spi = displayRam(emu) == reference && spiNanos == 2 * referenceNanos && emu.vbias() == 0x40;
+  }
+  printf("transport SPIClass at 4MHz      %s, %.1fus instead of %.1fus\n",
+         spi ? "same screen" : "WRONG", spiNanos / 1000.0, referenceNanos / 1000.0);
+
+  bool clock;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.setSpiClock(2000000UL);
+    lcd.begin();
+    emu.resetStats();
+    transportScreen(lcd);
+    clock = displayRam(emu) == reference && emu.stats().wireNanos == 4 * referenceNanos && lcd.spiClock() == 2000000UL;
+  }
+  printf("setSpiClock(2MHz)               %s\n", clock ? "same screen, 4x the wire time" : "WRONG");
+
+  bool bitBang;
+  uint32_t bytes;
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    BitBangWire wire(emu);
+    UC1609BitBangTransport transport(PIN_SCK, PIN_MOSI);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.setTransport(&transport);
+    lcd.begin();
+    emu.resetStats();
+    transportScreen(lcd);
+    bytes = emu.stats().bytes;
+    bitBang = displayRam(emu) == reference && emu.vbias() == 0x40;
+  }
+  printf("transport bit-bang              %s, %u bytes\n", bitBang ? "same screen" : "WRONG", bytes);
+
+  bool captured;
+  static uint8_t records[2048];
+  UC1609CaptureTransport capture(records, sizeof(records));
+  {
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.setTransport(&capture);
+    lcd.begin();
+    capture.clear();
+    transportScreen(lcd);
+  }
+  {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    replayCapture(emu, capture);
+    captured = !capture.overflowed() && displayRam(emu) == reference && emu.vbias() == 0x40;
+  }
+  printf("transport capture               %s, %u command and %u data bytes, %u bytes of records\n",
+         captured ? "replays the screen" : "WRONG", capture.commandBytes(), capture.dataBytes(), capture.length());
+  return (spi ? 0 : 1) + (clock ? 0 : 1) + (bitBang ? 0 : 1) + (captured ? 0 : 1);
+}
+
+/*
+ * begin() must leave the contrast at the requested Vbias potentiometer value, the second
+ * byte of the double-byte REG_VBIAS_POT command, and setContrast() must send it again
+ * after resetDisplay() even when the value is unchanged.
+ */
+static int checkBegin() {
+  UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+  UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+  lcd.begin(0x52);
+  bool ok = emu.vbias() == 0x52;
+  lcd.setContrast(0x30);
+  ok = ok && emu.vbias() == 0x30;
+  lcd.resetDisplay();                  // the controller is back at its default Vbias
+  ok = ok && emu.vbias() != 0x30;
+  lcd.setContrast(0x30);
+  ok = ok && emu.vbias() == 0x30;
+  printf("begin/setContrast vbias         %s\n", ok ? "as requested" : "WRONG");
+  return ok ? 0 : 1;
+}
+
+/*
+ * A tab near the right edge at font scale 4 must wrap the next character to the next
+ * line, as that character does without the tab, instead of drawing it over the start of
+ * the same line.
+ */
+static int checkTabWrap() {
+  std::vector<uint8_t> ram[2];
+  for (int tab = 0; tab < 2; tab++) {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    lcd.setFontScale(4);
+    lcd.setCursor(180, 0);
+    lcd.print(tab ? "\tX" : "X");
+    ram[tab] = displayRam(emu);
+  }
+  bool ok = ram[1] == ram[0];
+  printf("tab at scale 4 near the edge    %s\n", ok ? "wraps to the next line" : "WRONG");
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  const char *dumpDir = nullptr;
+  const char *goldenDir = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) dumpDir = argv[++i];
+    else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) goldenDir = argv[++i];
+    else {
+      fprintf(stderr, "usage: %s [--dump DIR] [--golden DIR]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  int failures = 0;
+  printf("%-20s %7s %6s %6s %6s %5s %5s %6s %9s\n",
+         "scenario", "bytes", "cmd", "data", "trans", "cs", "cd", "cmd%", "wire_us");
+
+  for (const Scenario &s : scenarios()) {
+    UC1609Emulator emu(PIN_CS, PIN_CD, PIN_RST);
+    UC1609 lcd(PIN_CS, PIN_CD, PIN_RST);
+    lcd.begin();
+    s.setup(lcd);
+    emu.resetStats();
+    s.action(lcd);
+
+    const UC1609WireStats &st = emu.stats();
+    printf("%-20s %7u %6u %6u %6u %5u %5u %5.1f%% %9.1f\n", s.name, st.bytes, st.commandBytes,
+           st.dataBytes, st.transactions, st.csToggles, st.cdToggles, 100.0f * st.commandRatio(),
+           st.wireNanos / 1000.0);
+
+    std::string file = std::string("/") + s.name + ".pbm";
+    if (dumpDir && !emu.writePBM((dumpDir + file).c_str())) {
+      fprintf(stderr, "%s: cannot write %s%s\n", s.name, dumpDir, file.c_str());
+      failures++;
+    }
+    if (goldenDir) {
+      long diff = emu.comparePBM((goldenDir + file).c_str());
+      if (diff != 0) {
+        fprintf(stderr, "%s: %s against %s%s\n", s.name,
+                diff < 0 ? "cannot compare" : "pixels differ", goldenDir, file.c_str());
+        failures++;
+      }
+    }
+    if (st.strayBytes || emu.unknownCommands()) {
+      fprintf(stderr, "%s: %u byte(s) sent without CS, %u unknown command(s)\n", s.name,
+              st.strayBytes, emu.unknownCommands());
+    }
+  }
+
+  printf("\n");
+  failures += checkBegin();
+  failures += checkTabWrap();
+  failures += checkDoubleSizeTables();
+  failures += checkGlyphCache();
+  failures += checkAntiAliasing();
+  failures += checkCompressedImages();
+  failures += checkAnimation();
+  failures += checkAsyncFlush();
+  failures += checkDrawQueue();
+  failures += checkChannel();
+  failures += checkSharedBus();
+  failures += checkSharedBusBackends();
+  failures += checkTransports();
+  printf("\n");
+  timeScaledGlyphs();
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""
+File Name:    uc1609_anim.py
+Description:  Encode a sequence of PBM, PGM or BMP frames into an animation for
+              UC1609Animation (see src/UC1609Animation.h for the format). The first frame
+              is stored as a compressed keyframe, every following frame only as the runs of
+              bytes that differ from the frame before (the non-zero bytes of their XOR), so
+              the cost of a frame on the wire follows what changed on the screen. Changed
+              bytes separated by a gap of up to --gap unchanged bytes are sent as one run,
+              which is cheaper than a new address.
+
+                uc1609_anim.py frame*.pbm --name spinner -o spinner.h
+                uc1609_anim.py boot_*.bmp --loop --name boot -o boot.h
+Github:       https://github.com/e-tinkers/uc1609
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from uc1609_compress import compress
+from uc1609_image import read_image, to_pages, WIDTH, HEIGHT
+
+
+def delta_runs(prev, cur, width, gap):
+    """Return (page, column, bytes) runs covering every byte of cur that differs from prev."""
+    runs = []
+    for page in range(len(cur) // width):
+        base = page * width
+        changed = [c for c in range(width) if prev[base + c] ^ cur[base + c]]
+        start = None
+        for c in changed:
+            if start is not None and c - end - 1 <= gap:
+                end = c
+                continue
+            if start is not None:
+                runs.append((page, start, cur[base + start:base + end + 1]))
+            start = end = c
+        if start is not None:
+            runs.append((page, start, cur[base + start:base + end + 1]))
+    return runs
+
+
+def encode(frames, width, height, loop, gap):
+    keyframe = bytes((width, height)) + compress(frames[0])
+    out = bytearray((width, height, 0, 1 if loop else 0, len(keyframe) & 0xFF, len(keyframe) >> 8))
+    out += keyframe
+    sequence = frames[1:] + ([frames[0]] if loop else [])
+    if len(sequence) > 255:
+        sys.exit('at most 255 frames after the keyframe')
+    out[2] = len(sequence)
+
+    prev = frames[0]
+    sizes = []
+    for cur in sequence:
+        g = gap
+        runs = delta_runs(prev, cur, width, g)
+        while len(runs) > 255:
+            g = g * 2 + 1
+            runs = delta_runs(prev, cur, width, g)
+        frame = bytearray((len(runs),))
+        for page, col, data in runs:
+            frame += bytes((page, col, len(data))) + data
+        out += frame
+        sizes.append((len(runs), sum(len(r[2]) for r in runs)))
+        prev = cur
+    return bytes(out), len(keyframe), sizes
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Encode frames into a UC1609Animation array.')
+    parser.add_argument('frames', nargs='+', help='PBM, PGM or BMP frames of the same size, in order')
+    parser.add_argument('--name', default='animation', help='array name (default animation)')
+    parser.add_argument('--loop', action='store_true', help='add a frame from the last frame back to the first')
+    parser.add_argument('--gap', type=int, default=3, help='unchanged bytes merged into a run (default 3)')
+    parser.add_argument('--threshold', type=int, default=128, help='grey level below which a pixel is set (default 128)')
+    parser.add_argument('--invert', action='store_true', help='set the light pixels instead of the dark ones')
+    parser.add_argument('-o', '--output', help='output header (default stdout)')
+    args = parser.parse_args()
+
+    frames = []
+    size = None
+    for path in args.frames:
+        try:
+            image = read_image(path)
+        except (OSError, ValueError, IndexError) as e:
+            sys.exit('%s: %s' % (path, e))
+        if size and (image.width, image.height) != size:
+            sys.exit('%s: %dx%d, the first frame is %dx%d' % ((path, image.width, image.height) + size))
+        size = (image.width, image.height)
+        frames.append(to_pages(image, args.threshold, args.invert))
+    width, height = size
+    if width > WIDTH or height > HEIGHT:
+        sys.exit('%dx%d frames do not fit on the %dx%d display' % (width, height, WIDTH, HEIGHT))
+
+    data, keysize, sizes = encode(frames, width, height, args.loop, args.gap)
+    header = os.path.basename(args.output) if args.output else args.name + '.h'
+    guard = re.sub(r'\W', '_', header).upper()
+    lines = ['// Generated by extras/tools/uc1609_anim.py ' + ' '.join(os.path.basename(a) for a in sys.argv[1:]),
+             '#ifndef ' + guard, '#define ' + guard, '',
+             '// %s: %dx%d, keyframe of %d bytes and %d frames, %d bytes (%d as full frames)' %
+             (args.name, width, height, keysize, len(sizes), len(data), len(frames[0]) * (len(sizes) + 1)),
+             '// data bytes per frame: ' + ' '.join(str(n) for _, n in sizes),
+             'IMAGE(%s) = {' % args.name]
+    for i in range(0, len(data), 16):
+        lines.append('  ' + ' '.join('0x%02X,' % b for b in data[i:i + 16]))
+    lines += ['};', '', '#endif', '']
+    text = '\n'.join(lines)
+    if args.output:
+        open(args.output, 'w').write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
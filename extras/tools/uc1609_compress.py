@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""
+File Name:    uc1609_compress.py
+Description:  Compress IMAGE() arrays for UC1609::drawCompressedImage().
+
+              The image bytes are kept in the page-major order of drawImage() (w bytes for
+              each page of 8 rows) and encoded as packets:
+
+                0x00-0x7F  n+1 literal bytes follow (1-128)
+                0x80-0xBF  run of n+1 0x00 bytes (1-64), no data byte
+                0xC0-0xFE  run of n+2 copies of the next byte (2-64)
+                0xFF n v   run of n+1 copies of v (1-256)
+
+              The compressed array starts with the width and the height of the image.
+
+                uc1609_compress.py image.h bitmap 192 64 > image_rle.h
+                uc1609_compress.py image.h bitmap 192 64 --name splash -o splash.h
+Github:       https://github.com/e-tinkers/uc1609
+"""
+
+import argparse
+import re
+import sys
+
+
+def read_array(path, name):
+    """Return the bytes of the C array `name` in a header."""
+    text = open(path).read()
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    text = re.sub(r'//[^\n]*', '', text)
+    m = re.search(r'IMAGE\(\s*' + re.escape(name) + r'\s*\)\s*=\s*\{(.*?)\}', text, re.S)
+    if not m:
+        m = re.search(r'\b' + re.escape(name) + r'\s*\[\s*\]\s*=\s*\{(.*?)\}', text, re.S)
+    if not m:
+        sys.exit('%s: array %s not found' % (path, name))
+    return bytes(int(v, 0) for v in m.group(1).replace('\n', ' ').split(',') if v.strip())
+
+
+def compress(data):
+    """Encode page-major image bytes into packets, see the format above."""
+    out = bytearray()
+    literal = bytearray()
+
+    def flush_literal():
+        while literal:
+            n = min(len(literal), 128)
+            out.append(n - 1)
+            out.extend(literal[:n])
+            del literal[:n]
+
+    i = 0
+    while i < len(data):
+        v = data[i]
+        run = 1
+        while i + run < len(data) and data[i + run] == v and run < 256:
+            run += 1
+        # a zero run costs one byte and other runs two, a single zero only starts a run
+        # when it does not interrupt a literal
+        if (v == 0 and (run >= 2 or not literal)) or run >= 3:
+            flush_literal()
+            if v == 0 and run <= 64:
+                out.append(0x80 + run - 1)
+            elif run <= 64:
+                out.extend((0xC0 + run - 2, v))
+            else:
+                out.extend((0xFF, run - 1, v))
+            i += run
+        else:
+            literal.append(v)
+            i += 1
+    flush_literal()
+    return bytes(out)
+
+
+def decompress(packets):
+    """Reference decoder used to check the output of compress()."""
+    out = bytearray()
+    i = 0
+    while i < len(packets):
+        c = packets[i]
+        i += 1
+        if c < 0x80:
+            out.extend(packets[i:i + c + 1])
+            i += c + 1
+        elif c < 0xC0:
+            out.extend(b'\x00' * (c - 0x80 + 1))
+        elif c < 0xFF:
+            out.extend(bytes([packets[i]]) * (c - 0xC0 + 2))
+            i += 1
+        else:
+            out.extend(bytes([packets[i + 1]]) * (packets[i] + 1))
+            i += 2
+    return bytes(out)
+
+
+def format_image(name, width, height, packets, source_size):
+    lines = ['// %s: %dx%d, %d bytes compressed from %d' % (name, width, height, len(packets) + 2, source_size),
+             'IMAGE(%s) = {' % name,
+             '  %d, %d,  // width, height' % (width, height)]
+    for i in range(0, len(packets), 16):
+        lines.append('  ' + ' '.join('0x%02X,' % b for b in packets[i:i + 16]))
+    lines.append('};')
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compress an IMAGE() array for drawCompressedImage().')
+    parser.add_argument('header', help='header file containing the IMAGE() array')
+    parser.add_argument('array', help='name of the array')
+    parser.add_argument('width', type=int, help='image width in pixels (1-192)')
+    parser.add_argument('height', type=int, help='image height in pixels (1-64), rounded up to whole pages')
+    parser.add_argument('--name', help='name of the compressed array (default <array>Rle)')
+    parser.add_argument('-o', '--output', help='output file (default stdout)')
+    args = parser.parse_args()
+
+    if not 1 <= args.width <= 192 or not 1 <= args.height <= 64:
+        sys.exit('image must fit on the 192x64 display')
+    data = read_array(args.header, args.array)
+    size = args.width * ((args.height + 7) // 8)
+    if len(data) < size:
+        sys.exit('%s has %d bytes, %dx%d needs %d' % (args.array, len(data), args.width, args.height, size))
+    data = data[:size]
+
+    packets = compress(data)
+    assert decompress(packets) == data
+    text = format_image(args.name or args.array + 'Rle', args.width, args.height, packets, size)
+    if args.output:
+        open(args.output, 'w').write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
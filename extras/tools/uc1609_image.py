@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""
+File Name:    uc1609_image.py
+Description:  Convert PBM, PGM and BMP images into IMAGE() arrays in the layout of
+              UC1609::drawImage(): for each page of 8 rows, one byte per column with the
+              top row in bit 0. The height is rounded up to whole pages with blank rows.
+
+              Dark pixels are set, a grey pixel is dark when it is below the threshold
+              (default 128), --invert sets the light pixels instead. Several images make an
+              atlas: one IMAGE() array holding all of them, and an offset table with a
+              <NAME>_OFFSET, <NAME>_WIDTH and <NAME>_HEIGHT define for each image.
+
+                uc1609_image.py splash.pbm > splash.h
+                uc1609_image.py photo.pgm --threshold 100 --crop 0,8,192,48 -o photo.h
+                uc1609_image.py thermometer.bmp humidity.bmp --atlas icons -o icons.h
+                uc1609_image.py splash.bmp --compress -o splash.h
+Github:       https://github.com/e-tinkers/uc1609
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+from uc1609_compress import compress
+
+WIDTH = 192
+HEIGHT = 64
+
+
+class Image:
+    """Grey levels 0 (black) - 255 (white), row-major."""
+
+    def __init__(self, width, height, pixels):
+        self.width = width
+        self.height = height
+        self.pixels = pixels
+
+    def crop(self, x, y, w, h):
+        if x < 0 or y < 0 or w <= 0 or h <= 0 or x + w > self.width or y + h > self.height:
+            raise ValueError('crop %d,%d,%d,%d is outside of the %dx%d image' % (x, y, w, h, self.width, self.height))
+        return Image(w, h, [self.pixels[(y + r) * self.width + x + c] for r in range(h) for c in range(w)])
+
+
+def _pnm_tokens(data):
+    """Yield the header tokens of a PNM file and the offset after the last one."""
+    pos = 0
+    while True:
+        while pos < len(data) and data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while pos < len(data) and data[pos:pos + 1] not in (b'\n', b'\r'):
+                pos += 1
+            continue
+        start = pos
+        while pos < len(data) and not data[pos:pos + 1].isspace():
+            pos += 1
+        yield data[start:pos], pos
+
+
+def read_pnm(data):
+    tokens = _pnm_tokens(data)
+    magic = next(tokens)[0]
+    if magic not in (b'P1', b'P2', b'P4', b'P5'):
+        raise ValueError('unsupported PNM type %s' % magic.decode(errors='replace'))
+    width = int(next(tokens)[0])
+    height, pos = next(tokens)
+    height = int(height)
+    maxval = 1
+    if magic in (b'P2', b'P5'):
+        maxval, pos = next(tokens)
+        maxval = int(maxval)
+    n = width * height
+
+    if magic == b'P1':
+        bits = re.findall(rb'[01]', data[pos:])[:n]
+        pixels = [0 if b == b'1' else 255 for b in bits]
+    elif magic == b'P2':
+        pixels = [int(v) * 255 // maxval for v in data[pos:].split()[:n]]
+    elif magic == b'P4':
+        stride = (width + 7) // 8
+        raster = data[pos + 1:pos + 1 + stride * height]
+        pixels = [0 if raster[r * stride + c // 8] & (0x80 >> (c % 8)) else 255
+                  for r in range(height) for c in range(width)]
+    else:
+        size = 2 if maxval > 255 else 1
+        raster = data[pos + 1:pos + 1 + n * size]
+        if size == 1:
+            pixels = [v * 255 // maxval for v in raster]
+        else:
+            pixels = [struct.unpack('>H', raster[i:i + 2])[0] * 255 // maxval for i in range(0, n * 2, 2)]
+    if len(pixels) < n:
+        raise ValueError('truncated image data')
+    return Image(width, height, pixels)
+
+
+def read_bmp(data):
+    if data[:2] != b'BM':
+        raise ValueError('not a BMP file')
+    offset = struct.unpack_from('<I', data, 10)[0]
+    header = struct.unpack_from('<I', data, 14)[0]
+    width, height, _, bpp, compression = struct.unpack_from('<iiHHI', data, 18)
+    if compression not in (0, 3):
+        raise ValueError('compressed BMP files are not supported')
+    if bpp not in (1, 4, 8, 24, 32):
+        raise ValueError('%d-bit BMP files are not supported' % bpp)
+    colors = struct.unpack_from('<I', data, 46)[0] if header >= 40 else 0
+    palette = []
+    if bpp <= 8:
+        table = 14 + header
+        for i in range(colors or (1 << bpp)):
+            b, g, r = data[table + i * 4:table + i * 4 + 3]
+            palette.append((r * 299 + g * 587 + b * 114) // 1000)
+
+    top_down = height < 0
+    height = abs(height)
+    stride = (width * bpp + 31) // 32 * 4
+    pixels = []
+    for r in range(height):
+        row = data[offset + (r if top_down else height - 1 - r) * stride:]
+        for c in range(width):
+            if bpp == 1:
+                pixels.append(palette[(row[c // 8] >> (7 - c % 8)) & 1])
+            elif bpp == 4:
+                pixels.append(palette[(row[c // 2] >> (4 if c % 2 == 0 else 0)) & 0x0F])
+            elif bpp == 8:
+                pixels.append(palette[row[c]])
+            else:
+                b, g, r_ = row[c * bpp // 8:c * bpp // 8 + 3]
+                pixels.append((r_ * 299 + g * 587 + b * 114) // 1000)
+    return Image(width, height, pixels)
+
+
+def read_image(path):
+    data = open(path, 'rb').read()
+    if data[:2] == b'BM':
+        return read_bmp(data)
+    return read_pnm(data)
+
+
+def to_pages(image, threshold, invert):
+    """Pack an image into page-major bytes, bit 0 is the top row of each page."""
+    out = bytearray()
+    for page in range((image.height + 7) // 8):
+        for col in range(image.width):
+            byte = 0
+            for bit in range(8):
+                row = page * 8 + bit
+                if row < image.height:
+                    dark = image.pixels[row * image.width + col] < threshold
+                    if dark != invert:
+                        byte |= 1 << bit
+            out.append(byte)
+    return bytes(out)
+
+
+def identifier(path):
+    name = re.sub(r'\W', '_', os.path.splitext(os.path.basename(path))[0])
+    return name if not name[:1].isdigit() else '_' + name
+
+
+def format_array(name, data, comment, prefix=b''):
+    lines = ['// ' + comment, 'IMAGE(%s) = {' % name]
+    if prefix:
+        lines.append('  %d, %d,  // width, height' % tuple(prefix))
+    for i in range(0, len(data), 16):
+        lines.append('  ' + ' '.join('0x%02X,' % b for b in data[i:i + 16]))
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert PBM/PGM/BMP images into UC1609 IMAGE() arrays.')
+    parser.add_argument('images', nargs='+', help='PBM (P1/P4), PGM (P2/P5) or BMP (1/4/8/24/32-bit) files')
+    parser.add_argument('--threshold', type=int, default=128, help='grey level below which a pixel is set (default 128)')
+    parser.add_argument('--invert', action='store_true', help='set the light pixels instead of the dark ones')
+    parser.add_argument('--crop', help='x,y,w,h region of each image to convert')
+    parser.add_argument('--name', help='array name of a single image (default the file name)')
+    parser.add_argument('--atlas', metavar='NAME', help='pack all images into one array NAME with an offset table')
+    parser.add_argument('--compress', action='store_true', help='write arrays for drawCompressedImage()')
+    parser.add_argument('-o', '--output', help='output header (default stdout)')
+    args = parser.parse_args()
+
+    if args.atlas and args.compress:
+        sys.exit('--atlas and --compress can not be combined')
+    if args.name and len(args.images) > 1 and not args.atlas:
+        sys.exit('--name needs a single image')
+
+    entries = []
+    for path in args.images:
+        try:
+            image = read_image(path)
+            if args.crop:
+                image = image.crop(*[int(v) for v in args.crop.split(',')])
+        except (OSError, ValueError, IndexError, struct.error) as e:
+            sys.exit('%s: %s' % (path, e))
+        if image.width > WIDTH or image.height > HEIGHT:
+            sys.exit('%s: %dx%d does not fit on the %dx%d display' % (path, image.width, image.height, WIDTH, HEIGHT))
+        entries.append((identifier(path), image, to_pages(image, args.threshold, args.invert)))
+
+    header = os.path.basename(args.output) if args.output else (args.atlas or args.name or entries[0][0]) + '.h'
+    guard = re.sub(r'\W', '_', header).upper()
+    out = ['// Generated by extras/tools/uc1609_image.py ' + ' '.join(os.path.basename(a) for a in sys.argv[1:]),
+           '#ifndef ' + guard, '#define ' + guard, '']
+
+    if args.atlas:
+        offset = 0
+        for name, image, data in entries:
+            macro = (args.atlas + '_' + name).upper()
+            out.append('#define %-32s %d' % (macro + '_OFFSET', offset))
+            out.append('#define %-32s %d' % (macro + '_WIDTH', image.width))
+            out.append('#define %-32s %d' % (macro + '_HEIGHT', image.height))
+            offset += len(data)
+        out.append('')
+        out.append('// offset, width and height of each image, in the order of the %s_<NAME> defines' % args.atlas.upper())
+        out.append('const uint16_t %sTable[][3] = {' % args.atlas)
+        offset = 0
+        for name, image, data in entries:
+            out.append('  {%d, %d, %d},  // %s' % (offset, image.width, image.height, name))
+            offset += len(data)
+        out.append('};')
+        out.append('')
+        out.append(format_array(args.atlas, b''.join(d for _, _, d in entries),
+                                '%s: %d images, %d bytes' % (args.atlas, len(entries), offset)))
+    else:
+        for name, image, data in entries:
+            name = args.name or name
+            if args.compress:
+                packed = compress(data)
+                out.append(format_array(name, packed, '%s: %dx%d, %d bytes compressed from %d' %
+                                        (name, image.width, image.height, len(packed) + 2, len(data)),
+                                        bytes((image.width, image.height))))
+            else:
+                out.append(format_array(name, data, '%s: %dx%d, %d bytes' % (name, image.width, image.height, len(data))))
+            out.append('')
+    out.append('')
+    out.append('#endif')
+
+    text = '\n'.join(out).replace('\n\n\n', '\n\n') + '\n'
+    if args.output:
+        open(args.output, 'w').write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
@@ -7,21 +7,342 @@
  */
 
 #include "UC1609.h"
+#include "UC1609Bus.h"
+#include "UC1609Transport.h"
+
+#if UC1609_MAX_SCALE < 2 || UC1609_MAX_SCALE > 8
+#error "UC1609_MAX_SCALE must be between 2 and 8"
+#endif
+
+#if UC1609_MAX_SCALE > 2
+/*
+ * Bit expansion tables for font scale 3 to UC1609_MAX_SCALE. Entry [(scale - 3) * 16 + n]
+ * holds the 4 bits of nibble n, each repeated scale times (e.g. scale 3: 0b0101 -> 0b000111000111).
+ */
+constexpr uint32_t _scaleNibble(uint8_t nibble, uint8_t scale, uint8_t bit) {
+  return bit == 4 ? 0 :
+    (((nibble >> bit) & 0x01) ? ((1UL << scale) - 1) << (bit * scale) : 0) | _scaleNibble(nibble, scale, bit + 1);
+}
+
+template <class Indices> struct UC1609ScaleTable;
+template <uint16_t... I> struct UC1609ScaleTable<UC1609Indices<I...> > {
+  static const uint32_t table[sizeof...(I)];
+};
+template <uint16_t... I>
+const uint32_t UC1609ScaleTable<UC1609Indices<I...> >::table[sizeof...(I)] FlashAttr = {
+  _scaleNibble(I & 0x0F, 3 + (I >> 4), 0)...
+};
+
+typedef UC1609ScaleTable<UC1609MakeIndices<(UC1609_MAX_SCALE - 2) * 16>::type> ScaleTable;
+
+/*
+ * Return page `page` (8 rows) of a font column scaled by `scale`, the low nibble expands
+ * to the first 4 x scale rows and the high nibble to the next 4 x scale rows.
+ */
+static uint8_t _scaledPage(uint8_t bits, uint8_t scale, uint8_t page) {
+  const uint32_t *lut = &ScaleTable::table[(scale - 3) * 16];
+  uint32_t lo = readFontDword(lut[bits & 0x0F]);
+  uint32_t hi = readFontDword(lut[bits >> 4]);
+  uint8_t half = 4 * scale;
+  uint8_t first = page * 8;
+
+  if (first >= half) return hi >> (first - half);
+  uint8_t b = lo >> first;
+  if (first + 8 > half) b |= hi << (half - first);
+  return b;
+}
+
+static void _setPixel(uint8_t *buf, uint8_t cols, uint8_t col, uint8_t row) {
+  buf[(row >> 3) * cols + col] |= 1 << (row & 0x07);
+}
+#endif
+
+/*
+ * Internal functions that drive CS and CD. On AVR the port register and bit mask of
+ * each pin are looked up once in begin(), a pin then toggles in a couple of cycles
+ * instead of the pin-to-port table lookups digitalWrite() does on every call.
+ */
+inline void UC1609::_csLow() {
+#ifdef UC1609_FAST_PINIO
+  *_csPort &= ~_csMask;
+#else
+  digitalWrite(_cs, LOW);
+#endif
+}
+
+inline void UC1609::_csHigh() {
+#ifdef UC1609_FAST_PINIO
+  *_csPort |= _csMask;
+#else
+  digitalWrite(_cs, HIGH);
+#endif
+}
+
+inline void UC1609::_commandMode() {
+#ifdef UC1609_FAST_PINIO
+  *_cdPort &= ~_cdMask;
+#else
+  digitalWrite(_cd, LOW);
+#endif
+}
+
+inline void UC1609::_dataMode() {
+#ifdef UC1609_FAST_PINIO
+  *_cdPort |= _cdMask;
+#else
+  digitalWrite(_cd, HIGH);
+#endif
+}
 
 /*
  * Internal function for setting a value at a specific LCD register via SPI. 
  * Command is clock-in to the register at the rising edge of CD pin.
+ * The command is sent right away, together with any queued command, unless it is
+ * inside a beginCommands()/commit() block.
  * param: reg - LCD register
  *        value - the value for configuring the register
  */
 void UC1609::_sendCommand(uint8_t reg, uint8_t value) {
-  SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-  digitalWrite(_cs, LOW);
-  digitalWrite(_cd, LOW); 
-  SPI.transfer(reg | value);
-  digitalWrite(_cd, HIGH); 
-  digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
+  _queueCommand(reg | value);
+  if (!_holdCommands) _sendCommands();
+}
+
+/*
+ * Internal functions of the command queue. Command bytes are collected in _cmdQueue and
+ * sent in one CD-low window of a single CS frame, by commit(), by the next data write
+ * to the panel, or when the queue is full.
+ */
+void UC1609::_queueCommand(uint8_t cmd) {
+#if UC1609_COMMAND_QUEUE > 0
+  if (_cmdCount == UC1609_COMMAND_QUEUE) _sendCommands();
+  _cmdQueue[_cmdCount++] = cmd;
+#else
+  // no queue, the command is sent at once, in the frame of the bus claim of the caller
+  _claimBus();
+  _commandMode();
+  if (_transport)
+    _transport->writeCommands(&cmd, 1);
+  else
+    SPI.transfer(cmd);
+  _dataMode();
+  _releaseBus();
+#endif
+}
+
+void UC1609::_sendCommands() {
+#if UC1609_COMMAND_QUEUE > 0
+  if (_cmdCount == 0) return;
+  _claimBus();
+  _commandMode();
+  if (_transport) {
+    _transport->writeCommands(_cmdQueue, _cmdCount);
+  }
+  else {
+    for (uint8_t i = 0; i < _cmdCount; i++) {
+      SPI.transfer(_cmdQueue[i]);
+    }
+  }
+  _dataMode();
+  _releaseBus();
+  _cmdCount = 0;
+#endif
+}
+
+/*
+ * Internal function that sends a command only if it changes the value of the register
+ * kept in `shadow`, e.g. rotate() to the orientation the display already has.
+ */
+void UC1609::_sendCommandIfChanged(uint8_t reg, uint8_t value, uint8_t &shadow) {
+  if (shadow == value) return;
+  shadow = value;
+  _sendCommand(reg, value);
+}
+
+/*
+ * Internal functions that claim the SPI bus and assert CS, or release them. Claims
+ * nest, only the outermost pair starts and ends the SPI transaction, so a function
+ * holding the bus can call any other drawing function, and everything inside a
+ * beginBatch()/endBatch() block shares one transaction.
+ */
+void UC1609::_claimBus() {
+  if (isBusy() && !_inService) _waitAsync();   // the panel is still busy with flushAsync()
+  if (_claimDepth++ == 0) {
+    if (_busDevice)
+      _busDevice->claim();
+    else if (_transport)
+      _transport->beginTransaction();
+    else
+      SPI.beginTransaction(_spiSettings);
+    _csLow();
+  }
+}
+
+void UC1609::_releaseBus() {
+  if (_claimDepth == 0) return;
+  if (--_claimDepth == 0) {
+    _csHigh();
+    if (_busDevice)
+      _busDevice->release();
+    else if (_transport)
+      _transport->endTransaction();
+    else
+      SPI.endTransaction();
+  }
+}
+
+/*
+ * Set the SPI clock of this display, which may differ from the other displays and devices
+ * on the bus, e.g. lower for long wires. The SPISettings are built here once, not for each
+ * transaction. With a transport, the clock is passed on to it.
+ * param: uint32_t clock - SPI clock in Hz (default SPI_CLOCK)
+ */
+void UC1609::setSpiClock(uint32_t clock) {
+  _spiClock = clock;
+  _spiSettings = SPISettings(clock, MSBFIRST, SPI_MODE0);
+  if (_transport) _transport->setClock(clock);
+}
+
+/*
+ * Internal functions for the display RAM output. Drawing functions only talk to the
+ * display RAM through these, so that the same drawing code either streams to the panel
+ * or writes to a RAM target (_ram): the framebuffer, whose dirty spans are updated, or
+ * a strip of renderStrips(), which only keeps the pages [_ramFirst, _ramFirst + _ramPages)
+ * and drops everything else.
+ * _beginTransfer()/_endTransfer() claim the SPI bus and assert CS around a sequence of
+ * _setAddress() and _writeData() calls. _setAddress() takes a line of the screen, which
+ * is mapped to a display RAM page in console mode.
+ */
+void UC1609::_beginTransfer() {
+  if (!_ram) _claimBus();
+}
+
+void UC1609::_endTransfer() {
+  if (!_ram) _releaseBus();
+}
+
+void UC1609::_setAddress(uint8_t col, uint8_t page) {
+  _setRamAddress(col, (page + _scrollPage) & (UC1609_PAGES - 1));
+}
+
+/*
+ * Same as _setAddress() with a display RAM page instead of a line on the screen,
+ * the two only differ in console mode where the screen is scrolled by _scrollPage.
+ * Only the parts of the address that differ from the controller address pointer
+ * (_hwCol/_hwPage, which follow the auto-increment of data writes) are queued: the low
+ * and high nibble of the column and the page are separate commands. They are sent with
+ * the next data write. Nothing is queued when the pointer is already there.
+ */
+void UC1609::_setRamAddress(uint8_t col, uint8_t page) {
+  if (_ram) {
+    _ramCol = col;
+    _ramPage = page;
+    return;
+  }
+
+  bool known = (_hwCol != UC1609_UNKNOWN);
+  bool colL = !known || (col & 0x0F) != (_hwCol & 0x0F);
+  bool colH = !known || (col & 0xF0) != (_hwCol & 0xF0);
+  bool pageChanged = !known || page != _hwPage;
+  if (!(colL || colH || pageChanged)) return;
+
+  if (colL) _queueCommand(REG_COL_ADDR_L | (col & 0x0F));
+  if (colH) _queueCommand(REG_COL_ADDR_H | (col & 0xF0) >> 4);
+  if (pageChanged) _queueCommand(REG_PAGE_ADDER | page);
+  _hwCol = col;
+  _hwPage = page;
+}
+
+/*
+ * Internal function returning whether the address pointer (of the RAM target or of
+ * the controller) is at column col of screen line `line`.
+ */
+bool UC1609::_addressAt(uint8_t col, uint8_t line) {
+  uint8_t page = (line + _scrollPage) & (UC1609_PAGES - 1);
+  if (_ram) return _ramCol == col && _ramPage == page;
+  return _hwCol == col && _hwPage == page;
+}
+
+/*
+ * Internal function returning a byte of the RAM target at a display RAM page, or 0 when
+ * it is outside of the target or there is no RAM target (the panel cannot be read).
+ */
+uint8_t UC1609::_readRam(uint8_t col, uint8_t page) {
+  uint8_t row = page - _ramFirst;
+  return (_ram && col < _width && row < _ramPages) ? _ram[row * _width + col] : 0;
+}
+
+/*
+ * Write one byte at the address pointer. With a RAM target the address pointer
+ * auto-increments and rolls over to the next page the same way the controller does,
+ * bytes outside of the target are dropped, and in framebuffer mode only bytes that
+ * actually change are added to the dirty span of the page.
+ */
+void UC1609::_writeData(uint8_t data) {
+  if (!_ram) {
+    if (_cmdCount) _sendCommands();
+    if (_transport)
+      _transport->write(data);
+    else
+      SPI.transfer(data);
+    if (_hwCol != UC1609_UNKNOWN && ++_hwCol >= _width) {
+      _hwCol = 0;
+      _hwPage = (_hwPage + 1) & (UC1609_PAGES - 1);
+    }
+    return;
+  }
+
+  uint8_t col = _ramCol;
+  uint8_t page = _ramPage;
+  uint8_t row = page - _ramFirst;   // wraps around for pages above the target
+  if (col < _width && row < _ramPages) {
+    uint8_t &b = _ram[row * _width + col];
+    if (b != data) {
+      b = data;
+      if (_fb) {
+        if (col < _fb->dirtyStart[page]) _fb->dirtyStart[page] = col;
+        if (col >= _fb->dirtyEnd[page]) _fb->dirtyEnd[page] = col + 1;
+      }
+    }
+  }
+  if (++col >= _width) {
+    col = 0;
+    page = (page + 1) & (UC1609_PAGES - 1);
+  }
+  _ramCol = col;
+  _ramPage = page;
+}
+
+/*
+ * Write a block of bytes at the address pointer. Like SPI.transfer(buf, len) the
+ * content of buf is undefined afterward.
+ */
+void UC1609::_writeData(uint8_t *buf, uint8_t len) {
+  if (!_ram) {
+    if (_cmdCount) _sendCommands();
+    if (_transport)
+      _transport->write(buf, len);
+    else
+      SPI.transfer(buf, len);
+    _advanceAddress(len);
+    return;
+  }
+  for (uint8_t i = 0; i < len; i++) {
+    _writeData(buf[i]);
+  }
+}
+
+/*
+ * Internal function moving the shadow of the controller address pointer over `len`
+ * data bytes, with the rollover of the column to the next page.
+ */
+void UC1609::_advanceAddress(uint16_t len) {
+  if (_hwCol == UC1609_UNKNOWN) return;
+  uint16_t col = _hwCol + len;
+  while (col >= _width) {
+    col -= _width;
+    _hwPage = (_hwPage + 1) & (UC1609_PAGES - 1);
+  }
+  _hwCol = col;
 }
 
 /* Strentch a byte into a 16-bit word, based on the algorithm in
@@ -35,46 +356,45 @@ uint16_t UC1609::_stretch(uint8_t x) {
   return d | d << 1;                // d = aabbccdd eeffgghh
 }
 
+/*
+ * Smooth the staircase of a stretched glyph. array[] holds the 12 top page columns
+ * followed by the 12 bottom page columns, each glyph column is array[n] (bits 0-7)
+ * and array[n+12] (bits 8-15). Where two adjacent source columns form a diagonal
+ * (one has the 2-bit pattern 0b1100 and the other 0b0011 at the same bit pair), the
+ * inner corner pixel of each column is filled. Only the pairs on a boundary between
+ * two stretched source columns, (2,3), (4,5), (6,7) and (8,9), can form a diagonal.
+ * All bit pairs are matched at once with masks (see _uc1609Rising() in UC1609DoubleSize.h),
+ * two column pairs per 32-bit word: l holds columns k and k+2, r columns k+1 and k+3.
+ *   zeros: bit 2i set when bits 2i and 2i+1 are both clear
+ *   ones:  bit 2i set when bits 2i and 2i+1 are both set
+ * Masking with 0x0555 per half keeps bit pairs 0-5 and stops the shifts carrying
+ * from one half into the other.
+ */
 void UC1609::_antiAliasing(uint8_t *array) {
+  for (uint8_t k = 2; k < 10; k += 4) {
+    uint32_t l = (uint32_t) array[k+14] << 24 | (uint32_t) array[k+2] << 16 | (uint16_t) array[k+12] << 8 | array[k];
+    uint32_t r = (uint32_t) array[k+15] << 24 | (uint32_t) array[k+3] << 16 | (uint16_t) array[k+13] << 8 | array[k+1];
 
-  uint8_t temp[24];
-  memcpy(temp, array, 24);
-
- for (int adjL=2; adjL<22; adjL=adjL+2) {
-    uint16_t pattern1 = 0x000C;
-    uint16_t pattern2 = 0x0003;
-    uint16_t patternMask = 0x000F;
-    
-    uint16_t bitAddedL = 0x0002;
-    uint16_t bitAddedR = 0x0004;
-    
-    uint16_t matching{0};
-    uint8_t adjR = adjL + 1;
-    
-    for (int i=0; i<6; i++) {
-      uint16_t adjL16 = (uint16_t) array[adjL+12] << 8 | array[adjL];
-      uint16_t adjR16 = (uint16_t) array[adjR+12] << 8 | array[adjR];
-      matching = (((adjL16 & patternMask) == pattern1) & ((adjR16  & patternMask) == pattern2));
-      if (matching) {
-        temp[adjL] |= bitAddedL;
-        temp[adjR] |= bitAddedR;
-      }     
-      matching = (((adjL16 & patternMask) == pattern2) & ((adjR16 & patternMask) == pattern1));
-      if (matching) {
-        temp[adjL] |= bitAddedR;
-        temp[adjR] |= bitAddedL;
-      }
+    uint32_t zerosL = ~l & (~l >> 1) & 0x55555555UL;
+    uint32_t onesL = l & (l >> 1) & 0x55555555UL;
+    uint32_t zerosR = ~r & (~r >> 1) & 0x55555555UL;
+    uint32_t onesR = r & (r >> 1) & 0x55555555UL;
 
-      pattern1 <<= 2;
-      pattern2 <<= 2;
-      patternMask <<= 2;
-      bitAddedL <<= 2;
-      bitAddedR <<= 2;
-    }
-  }
+    uint32_t falling = onesL & (zerosL >> 2) & zerosR & (onesR >> 2) & 0x05550555UL;  // left 0b0011, right 0b1100
+    uint32_t rising = zerosL & (onesL >> 2) & onesR & (zerosR >> 2) & 0x05550555UL;   // left 0b1100, right 0b0011
 
-  memcpy(array, temp, 24);
+    uint32_t addedL = rising << 1 | falling << 2;
+    uint32_t addedR = rising << 2 | falling << 1;
 
+    array[k] |= addedL;
+    array[k+12] |= addedL >> 8;
+    array[k+2] |= addedL >> 16;
+    array[k+14] |= addedL >> 24;
+    array[k+1] |= addedR;
+    array[k+13] |= addedR >> 8;
+    array[k+3] |= addedR >> 16;
+    array[k+15] |= addedR >> 24;
+  }
 }
 
 /*
@@ -93,37 +413,54 @@ void UC1609::begin (uint8_t VbiasPot) {
   pinMode(_cd, OUTPUT);
   pinMode(_cs, OUTPUT);
 
+#ifdef UC1609_FAST_PINIO
+  _csPort = portOutputRegister(digitalPinToPort(_cs));
+  _cdPort = portOutputRegister(digitalPinToPort(_cd));
+  _csMask = digitalPinToBitMask(_cs);
+  _cdMask = digitalPinToBitMask(_cd);
+#endif
+
   // if RST pin is actually defined with a pin, set it as OUTPUT, otherwise skip it
   if (_rst != -1) {
     digitalWrite(_rst, HIGH);
     pinMode(_rst, OUTPUT);
   }
   
-  SPI.begin();
+  if (_transport)
+    _transport->begin();
+  else
+    SPI.begin();
 
   _scale = 1;             // Normal font size
   _padding = 1; 
   _antiAliasingEnable = true;
-  _VbiasPOT = VbiasPot;   // DEFAULT_VBIAS_POT or user-provided constract value
 
   resetDisplay();
+  _VbiasPOT = VbiasPot;   // DEFAULT_VBIAS_POT or user-provided constract value
 
-  SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-  digitalWrite(_cs, LOW); 
-  digitalWrite(_cd, LOW); 
-  SPI.transfer(REG_SYSTEM_RESET | 0);
-  SPI.transfer(REG_VBIAS_POT | 0);
-  SPI.transfer(REG_VBIAS_POT | _VbiasPOT);
-  SPI.transfer(REG_MAPPING_CTRL | NORMAL_ORIENTATION); // can be ROTATED
-  SPI.transfer(REG_COL_ADDR_L | 0);
-  SPI.transfer(REG_COL_ADDR_H | 0);
-  SPI.transfer(REG_PAGE_ADDER | 0);
-  SPI.transfer(REG_SCROLL | 0);
-  SPI.transfer(REG_INVERSE_DISPLAY | 0);
-  SPI.transfer(REG_DISPLAY_ENABLE | DISPLAY_ON);
-  digitalWrite(_cd, HIGH); 
-  digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
+  _cmdCount = 0;
+  _claimBus();                                         // one frame without a command queue
+  _queueCommand(REG_SYSTEM_RESET);
+  _queueCommand(REG_VBIAS_POT);
+  _queueCommand(_VbiasPOT);                            // second byte of REG_VBIAS_POT
+  _queueCommand(REG_MAPPING_CTRL | NORMAL_ORIENTATION); // can be ROTATED
+  _queueCommand(REG_COL_ADDR_L | 0);
+  _queueCommand(REG_COL_ADDR_H | 0);
+  _queueCommand(REG_PAGE_ADDER | 0);
+  _queueCommand(REG_SCROLL | 0);
+  _queueCommand(REG_INVERSE_DISPLAY | 0);
+  _queueCommand(REG_DISPLAY_ENABLE | DISPLAY_ON);
+  _sendCommands();
+  _releaseBus();
+  _hwCol = 0;
+  _hwPage = 0;
+  _hwScroll = 0;
+  _hwMapping = NORMAL_ORIENTATION;
+  _hwInverse = 0;
+  _hwAllPixelOn = 0;
+  _hwFrameRate = FRAME_RATE_95;   // reset defaults
+  _hwBiasRatio = BIAS_RATIO_9;
+  _hwTempComp = 0;
 
   clearDisplay();
 }
@@ -138,6 +475,10 @@ void UC1609::begin (uint8_t VbiasPot) {
 void UC1609::resetDisplay() {
   if (_rst == -1) return;
 
+  _hwCol = _hwPage = UC1609_UNKNOWN;
+  _hwScroll = _hwMapping = _hwInverse = _hwAllPixelOn = UC1609_UNKNOWN;
+  _hwFrameRate = _hwBiasRatio = _hwTempComp = UC1609_UNKNOWN;
+  _VbiasPOT = UC1609_UNKNOWN;   // back at the power-on default, the next setContrast() is sent
   digitalWrite(_rst, LOW);
   delayMicroseconds(3);
   digitalWrite(_rst, HIGH);
@@ -150,7 +491,7 @@ void UC1609::resetDisplay() {
  * return: void
  */
 void UC1609::enableDisplay(uint8_t onOff) {
-  _sendCommand(REG_ALL_PIXEL_ON, onOff);
+  _sendCommandIfChanged(REG_ALL_PIXEL_ON, onOff, _hwAllPixelOn);
 }
 
 /*
@@ -159,20 +500,52 @@ void UC1609::enableDisplay(uint8_t onOff) {
  * return: void
  */
 void UC1609::clearDisplay() {
-  SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-  digitalWrite(_cs, LOW);
-  uint16_t bytes = _width * (_height / 8); // width * page
-  for (uint16_t i = 0; i < bytes; i++) {
-    SPI.transfer(0);
-  }
-  digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
+  fillRect(0, 0, _width, _height / 8, 0);
+  if (_textBuffer)
+    _textBuffer->reset();
   _crow = 0;
   _ccol = 0;
 }
 
 /*
- * Sets the cursor to col, page location
+ * Fill a rectangle of whole pages with a data pattern, e.g. 0x00 to clear it or 0xFF to
+ * fill it. The address is set once per page (once for full-width rectangles, which rely
+ * on the page rollover of the address pointer) and the data is sent with block transfers
+ * of a small chunk buffer. The rectangle is clipped to the display, the cursor is not moved.
+ * param: uint8_t x - 0-191 first column
+ *        uint8_t page - 0-7 first line
+ *        uint8_t w - width in columns
+ *        uint8_t pages - height in lines
+ *        uint8_t pattern - byte written to every column of every page (bit 0 at the top)
+ * return: void
+ */
+void UC1609::fillRect(uint8_t x, uint8_t page, uint8_t w, uint8_t pages, uint8_t pattern) {
+  if (x >= _width || page >= UC1609_PAGES) return;
+  if (w > _width - x) w = _width - x;
+  if (pages > UC1609_PAGES - page) pages = UC1609_PAGES - page;
+  if (w == 0 || pages == 0) return;
+
+  bool fullWidth = (w == _width);
+  uint16_t run = fullWidth ? (uint16_t) w * pages : w;
+  uint8_t runs = fullWidth ? 1 : pages;
+  uint8_t chunk[32];
+
+  _beginTransfer();
+  for (uint8_t p = 0; p < runs; p++) {
+    _setAddress(x, page + p);
+    for (uint16_t left = run; left > 0; ) {
+      uint8_t n = (left < sizeof(chunk)) ? left : sizeof(chunk);
+      memset(chunk, pattern, n);   // refilled every time, the block transfer overwrites it
+      _writeData(chunk, n);
+      left -= n;
+    }
+  }
+  _endTransfer();
+}
+
+/*
+ * Sets the cursor to col, page location. Nothing is sent to the display, the address
+ * is set by the next write() when it is not already there.
  * param:  uint8_t col - 0-191 column number
  *         uint8_t page - 0-7 page number (i.e. line number)
  * return: void
@@ -180,15 +553,6 @@ void UC1609::clearDisplay() {
 void UC1609::setCursor(uint8_t col, uint8_t line) {
   _crow = line;
   _ccol = col;
-  SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-  digitalWrite(_cs, LOW);
-  digitalWrite(_cd, LOW);
-  SPI.transfer(REG_COL_ADDR_L | (col & 0x0F)); 
-  SPI.transfer(REG_COL_ADDR_H | (col & 0xF0) >> 4);
-  SPI.transfer(REG_PAGE_ADDER | line); 
-  digitalWrite(_cd, HIGH);
-  digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
 }
 
 /*
@@ -199,15 +563,8 @@ void UC1609::setCursor(uint8_t col, uint8_t line) {
  * return: void
  */
 void UC1609::drawLine(uint8_t line, uint8_t dataPattern) {
-  setCursor(0, line);
-  SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-  digitalWrite(_cs, LOW);
-  for (uint16_t i = 0; i < _width; i++) {
-    SPI.transfer(dataPattern);
-  }
-  digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
-  _crow = line * _height;
+  fillRect(0, line, _width, 1, dataPattern);
+  _crow = line;     // cursor at the end of the line, the next character wraps to the next line
   _ccol = _width;
 }
 
@@ -227,7 +584,26 @@ void UC1609::clearLine(uint8_t line) {
  * return: void
  */
 void UC1609::scroll(uint8_t yPixel) {
-  _sendCommand(REG_SCROLL, yPixel);
+  _sendCommandIfChanged(REG_SCROLL, yPixel, _hwScroll);
+}
+
+/*
+ * Console mode for rolling text such as an event log. Instead of clearing the whole
+ * display when the text runs past the last line, the display RAM is used as a circular
+ * buffer: a new line only clears the line(s) it moves into, and the screen is scrolled
+ * up with the scroll line register. Lines given to setCursor(), drawLine(), drawImage(),
+ * etc. are lines of the screen as it is currently scrolled. Enabling or disabling the
+ * console mode clears the display and resets the scroll line, scroll() should not be
+ * used while it is enabled.
+ * param:  bool enable - true to enable console mode, false for the default clear-on-overflow
+ * return: void
+ */
+void UC1609::setConsoleMode(bool enable) {
+  _console = enable;
+  _scrollPage = 0;
+  _scrollPending = false;
+  scroll(0);
+  clearDisplay();
 }
 
 /*
@@ -237,7 +613,7 @@ void UC1609::scroll(uint8_t yPixel) {
  * return: void
  */
 void UC1609::rotate(uint8_t rotateValue) {
-  _sendCommand(REG_MAPPING_CTRL, rotateValue & B00000110);
+  _sendCommandIfChanged(REG_MAPPING_CTRL, rotateValue & B00000110, _hwMapping);
 }
 
 /*
@@ -247,15 +623,220 @@ void UC1609::rotate(uint8_t rotateValue) {
  * return: void
  */
 void UC1609::invert(bool invert) {
-  _sendCommand(REG_INVERSE_DISPLAY, invert);
+  _sendCommandIfChanged(REG_INVERSE_DISPLAY, invert, _hwInverse);
+}
+
+/*
+ * Set the display contrast (Vbias potentiometer), the same value as passed to begin().
+ * param:  uint8_t VbiasPot - 0x00-0xFE, default DEFAULT_VBIAS_POT (0x49)
+ * return: void
+ */
+void UC1609::setContrast(uint8_t VbiasPot) {
+  if (VbiasPot == _VbiasPOT) return;
+  _VbiasPOT = VbiasPot;
+#if UC1609_COMMAND_QUEUE > 0
+  if (_cmdCount + 2 > UC1609_COMMAND_QUEUE) _sendCommands();  // keep the two bytes together
+  _queueCommand(REG_VBIAS_POT);
+  _queueCommand(VbiasPot);
+  if (!_holdCommands) _sendCommands();
+#else
+  _claimBus();                                                  // keep the two bytes together
+  _queueCommand(REG_VBIAS_POT);
+  _queueCommand(VbiasPot);
+  _releaseBus();
+#endif
+}
+
+/*
+ * Set the frame rate of the display.
+ * param:  uint8_t frameRate - FRAME_RATE_76, FRAME_RATE_95 (default), FRAME_RATE_132 or FRAME_RATE_168
+ * return: void
+ */
+void UC1609::setFrameRate(uint8_t frameRate) {
+  _sendCommandIfChanged(REG_FRAMERATE_REG, frameRate & 0x03, _hwFrameRate);
+}
+
+/*
+ * Set the bias ratio between V-LCD and V-D.
+ * param:  uint8_t biasRatio - BIAS_RATIO_6, BIAS_RATIO_7, BIAS_RATIO_8 or BIAS_RATIO_9 (default)
+ * return: void
+ */
+void UC1609::setBiasRatio(uint8_t biasRatio) {
+  _sendCommandIfChanged(REG_BIAS_RATIO, biasRatio & 0x03, _hwBiasRatio);
+}
+
+/*
+ * Set the temperature compensation coefficient of V-LCD.
+ * param:  uint8_t tempComp - TC[1:0] 0 (default) - 3, see the datasheet
+ * return: void
+ */
+void UC1609::setTempCompensation(uint8_t tempComp) {
+  _sendCommandIfChanged(REG_TEMP_COMP_REG, tempComp & 0x03, _hwTempComp);
+}
+
+/*
+ * Queue the register writes of the following calls (setContrast(), rotate(), invert(),
+ * scroll(), setFrameRate(), etc.) instead of sending each one in its own SPI
+ * transaction. commit() sends all of them with a single CS assertion, the queue is also
+ * sent ahead of the next data written to the display, or when it is full.
+ * param:  void
+ * return: void
+ */
+void UC1609::beginCommands() {
+  _holdCommands = true;
+}
+
+void UC1609::commit() {
+  _holdCommands = false;
+  _sendCommands();
 }
 
 void UC1609::setFont(const uint8_t * font) {
   _font = font;
+  _font2x = nullptr;
+}
+
+/*
+ * Select a pre-stretched double-size table generated at compile time from the current
+ * font (see UC1609DoubleSize.h). At font scale 2, glyphs are then copied from the table
+ * instead of being stretched and anti-aliased at runtime; whether they are anti-aliased
+ * is decided by the table (UC1609_DOUBLE_SIZE or UC1609_DOUBLE_SIZE_NOAA), not by
+ * setAntiAliasing(). setFont() deselects the table, so call this after setFont().
+ * param: const uint8_t * table - UC1609_DOUBLE_SIZE(font), or nullptr to stretch at runtime
+ */
+void UC1609::setDoubleSizeFont(const uint8_t * table) {
+  _font2x = table;
+}
+
+/*
+ * Attach a RAM cache of scaled glyphs (see UC1609GlyphCache.h). Scaled glyphs are looked
+ * up in the cache before they are stretched and anti-aliased, and stored in it after.
+ * A pre-stretched table selected with setDoubleSizeFont() takes precedence.
+ * param: UC1609GlyphCache *cache - the cache, or nullptr to detach it
+ */
+void UC1609::setGlyphCache(UC1609GlyphCache *cache) {
+  _glyphCache = cache;
+}
+
+/*
+ * Attach a character-cell buffer (see UC1609TextBuffer.h). While it is attached, text
+ * printed at font scale 1 only updates the buffer, on a grid of cells as wide as a
+ * character, and is drawn by refresh(). All cells are marked dirty so that the next
+ * refresh() redraws the whole screen.
+ * param: UC1609TextBuffer *textBuffer - the buffer, or nullptr to detach it
+ */
+void UC1609::setTextBuffer(UC1609TextBuffer *textBuffer) {
+  _textBuffer = textBuffer;
+  if (_textBuffer)
+    _textBuffer->invalidate();
 }
 
+/*
+ * Draw the cells of the text buffer that have changed since the previous refresh(), in
+ * a single SPI transaction. Adjacent changed cells of a line are sent as one data stream
+ * after one address, unchanged cells are skipped. With a framebuffer attached the cells
+ * are drawn into the framebuffer and sent by the next flush().
+ */
+void UC1609::refresh() {
+  if (!_textBuffer) return;
+
+  uint8_t fontWidth = readFontByte(_font[0]);
+  uint8_t fontStart = readFontByte(_font[2]);
+  uint8_t fontEnd = readFontByte(_font[3]);
+  uint8_t advance = fontWidth + 1;
+  uint8_t cols = _width / advance;
+  if (cols > UC1609_TEXT_COLUMNS) cols = UC1609_TEXT_COLUMNS;
+
+  uint8_t stream[30];
+  uint8_t len = 0;
+
+  _beginTransfer();
+  for (uint8_t row = 0; row < UC1609_TEXT_ROWS; row++) {
+    if (!_textBuffer->isLineDirty(row)) continue;
+    bool run = false;
+    for (uint8_t col = 0; col < cols; col++) {
+      if (!_textBuffer->isDirty(col, row)) {
+        run = false;
+        continue;
+      }
+      if (len && (!run || len + advance > sizeof(stream))) {
+        _writeData(stream, len);
+        len = 0;
+      }
+      if (!run) {
+        _setAddress(col * advance, row);
+        run = true;
+      }
+
+      uint8_t ch = _textBuffer->get(col, row);
+      uint8_t invert = _textBuffer->isInverse(col, row) ? 0xFF : 0x00;
+      stream[len++] = invert;  // padding col
+      for (uint8_t i = 0; i < fontWidth; i++) {
+        uint8_t data = (ch >= fontStart && ch <= fontEnd) ? readFontByte(_font[(ch - fontStart) * fontWidth + 4 + i]) : 0x00;
+        stream[len++] = data ^ invert;
+      }
+      _textBuffer->markClean(col, row);
+    }
+    if (len) {
+      _writeData(stream, len);
+      len = 0;
+    }
+  }
+  _endTransfer();
+}
+
+/*
+ * Internal function that prints into the text buffer, the counterpart of write() for
+ * text at scale 1 while a text buffer is attached. Lines wrap at the last cell that fits
+ * on the display, and a new line below the last one goes back to the top line instead of
+ * clearing the display.
+ */
+size_t UC1609::_writeText(const uint8_t *buffer, size_t size) {
+  uint8_t fontWidth = readFontByte(_font[0]);
+  uint8_t fontStart = readFontByte(_font[2]);
+  uint8_t fontEnd = readFontByte(_font[3]);
+  uint8_t advance = fontWidth + 1;
+  uint8_t cols = _width / advance;
+  if (cols > UC1609_TEXT_COLUMNS) cols = UC1609_TEXT_COLUMNS;
+
+  for (size_t i = 0; i < size; i++) {
+    uint8_t ch = buffer[i];
+    switch (ch) {
+      case '\r':
+        _ccol = 0;
+        continue;
+      case '\n':
+        _ccol = 0;
+        _crow = (_crow + 1) % UC1609_TEXT_ROWS;
+        continue;
+      case '\t':
+        // tab = 4 spaces, stopping at the right edge, the next character wraps
+        _ccol = (_ccol + 4 * advance < _width) ? _ccol + 4 * advance : _width;
+        continue;
+      case '\b':
+        _ccol = (_ccol > advance) ? _ccol - advance : 0;
+        continue;
+      default:
+        if (ch < fontStart || ch > fontEnd)
+          continue;
+    }
+
+    if (_ccol / advance >= cols) {
+      _ccol = 0;
+      _crow = (_crow + 1) % UC1609_TEXT_ROWS;
+    }
+    _textBuffer->put(_ccol / advance, _crow, ch);
+    _ccol += advance;
+  }
+  return size;
+}
+
+/*
+ * Set the font scale, 1 (6x8 including padding), 2 (12x16) up to UC1609_MAX_SCALE
+ * (default 4, i.e. 24x32). Characters at scale n span n lines.
+ */
 void UC1609::setFontScale(uint8_t scale) {
-  if (scale == 1 || scale == 2) {
+  if (scale >= 1 && scale <= UC1609_MAX_SCALE) {
     _scale = scale;
     _padding = scale;
   }
@@ -266,64 +847,82 @@ void UC1609::setAntiAliasing(bool enable) {
 }
 
 /*
- * Print a printable character 
- * param: const char ch - ASCII value of the character
- * return: 0 - failed, 1 - success
+ * Internal function that moves the cursor to the beginning of the next line, the
+ * display is cleared when the next line does not fit on the screen. In console mode
+ * the screen is scrolled up instead, and only the line(s) of the new text line are
+ * cleared, before scrolling so that the oldest line disappears first.
  */
-size_t UC1609::write(uint8_t ch) {
+void UC1609::_newLine() {
+  _ccol = 0;
+  _crow += _scale;
+  if (!_console) {
+    if (_crow + _scale > _height/8)
+      clearDisplay();
+    return;
+  }
 
-  uint8_t fontWidth = readFontByte(_font[0]);
-  uint8_t fontStart = readFontByte(_font[2]);
+  uint8_t overflow = 0;
+  if (_crow + _scale > _height/8) {
+    overflow = _crow + _scale - _height/8;
+    _crow -= overflow;
+    _scrollPage = (_scrollPage + overflow) & (UC1609_PAGES - 1);
+  }
 
-  switch (ch) {
-    case '\r':
-      _ccol = 0;
-      return 1;
-    case '\n':
-      _crow += _scale;
-      if (_crow >= _height/8)
-        clearDisplay();
-      setCursor(0, _crow);
-      return 1;
-    case '\t':
-      _ccol += (4 * (fontWidth * _scale + _padding));  // tab = 4 spaces
-      setCursor(_ccol, _crow);
-      return 1;
-    case '\b':
-      // move the cursor back one space but does not delete the char in place
-      if (_ccol != 0) _ccol -= (fontWidth * _scale + _padding);
-      setCursor(_ccol, _crow);
-      return 1;
-    default:
-      if (ch >= fontStart && ch <= readFontByte(_font[3]))
-        break;
-      return 1;
-  }
-
-  // wrap text to next line if the text is wider than screen width
-  if (_ccol >= _width) {
-    _ccol = 0;
-    _crow += _scale;
-    if (_crow >= _height/8)
-        clearDisplay();
-    setCursor(_ccol, _crow);
-  }
-
-  if (_scale == 1) {
-    SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-    digitalWrite(_cs, LOW);
-    SPI.transfer(0x00); // padding col
-    for (uint8_t  col=0; col<fontWidth; col++) {
-      SPI.transfer(readFontByte(_font[(ch - fontStart) * fontWidth + col + 4]));
-    }
-    digitalWrite(_cs, HIGH);
-    SPI.endTransaction();
+  fillRect(0, _crow, _width, _scale, 0);
+
+  if (overflow) {
+    if (_ram)
+      _scrollPending = true;   // sent by flush() together with the cleared lines
+    else
+      scroll(_scrollPage * 8);
   }
-  else {
-    uint8_t buf[24]{0};  // each stretched font is 12x2 bytes, 12 bits wide, and 16 bits high
+}
+
+/*
+ * Internal function that writes a scaled glyph of `pages` pages of `cols` columns,
+ * page-major in buf, at the cursor location. Pages below the last line are clipped.
+ * The pages are written top-down, or bottom-up when the previous glyph left the address
+ * pointer on the last page, so consecutive glyphs on a line snake between the pages and
+ * every other glyph starts without an address command.
+ */
+void UC1609::_writeGlyphPages(uint8_t *buf, uint8_t cols, uint8_t pages) {
+  if (_crow >= UC1609_PAGES) return;
+  if (_crow + pages > UC1609_PAGES) pages = UC1609_PAGES - _crow;
+
+  bool up = pages > 1 && _addressAt(_ccol, _crow + pages - 1);
+  for (uint8_t i = 0; i < pages; i++) {
+    uint8_t p = up ? pages - 1 - i : i;
+    _setAddress(_ccol, _crow + p);
+    _writeData(&buf[p * cols], cols);
+  }
+}
+
+/*
+ * Internal function that stretches a glyph to double size and writes it at the
+ * cursor location, it spans two pages.
+ * param: const uint8_t *glyph - glyph columns in the font table
+ *        uint8_t fontWidth - number of columns of the glyph
+ */
+void UC1609::_writeDoubleSize(const uint8_t *glyph, uint8_t fontWidth) {
+  uint8_t buf[24]{0};  // each stretched font is 12x2 bytes, 12 bits wide, and 16 bits high
 
+  if (_font2x) {
+    // pre-stretched table, glyph n of _font is at the same index in _font2x
+    const uint8_t *src = &_font2x[4 + (glyph - &_font[4]) / fontWidth * UC1609_DOUBLE_GLYPH_SIZE];
+    for (uint8_t i = 0; i < UC1609_DOUBLE_GLYPH_SIZE; i++) {
+      buf[i] = readFontByte(src[i]);
+    }
+    _writeGlyphPages(buf, 12, 2);
+    return;
+  }
+
+  uint8_t *cached = _glyphCache ? _glyphCache->find(glyph, _scale, _antiAliasingEnable) : nullptr;
+  if (cached) {
+    memcpy(buf, cached, sizeof(buf));
+  }
+  else {
     for (uint8_t x = 0; x < fontWidth; x++) {
-      uint16_t stretched = _stretch(readFontByte(_font[(ch - fontStart) * fontWidth + x + 4]));
+      uint16_t stretched = _stretch(readFontByte(glyph[x]));
       buf[x * 2 + 1] = stretched & 0xFF;
       buf[x * 2 + 2] = stretched & 0xFF;
       buf[x * 2 + 13] = (uint8_t) (stretched >> 8);
@@ -332,62 +931,626 @@ size_t UC1609::write(uint8_t ch) {
 
     if (_antiAliasingEnable) _antiAliasing(buf);
 
-    setCursor(_ccol, _crow);
+    if (_glyphCache) {
+      uint8_t *entry = _glyphCache->store(glyph, _scale, _antiAliasingEnable);
+      if (entry) memcpy(entry, buf, sizeof(buf));
+    }
+  }
 
-    SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-    digitalWrite(_cs, LOW);
-    SPI.transfer(&buf[0], 12); // padding at beginning
+  _writeGlyphPages(buf, 12, 2);
+}
+
+/*
+ * Internal function that scales a glyph by 3 or more and writes it at the cursor location,
+ * one data stream per page. The glyph spans _scale pages.
+ * Smoothing generalises _antiAliasing(): where two adjacent source columns form a
+ * diagonal at rows y, y+1, the staircase corner between the two blocks is filled with a
+ * triangle of scale - 1 pixels per side, which is exactly the 2-pixel fill at scale 2.
+ * param: const uint8_t *glyph - glyph columns in the font table
+ *        uint8_t fontWidth - number of columns of the glyph (5 for all the fonts)
+ */
+void UC1609::_writeScaled(const uint8_t *glyph, uint8_t fontWidth) {
+#if UC1609_MAX_SCALE > 2
+  uint8_t buf[UC1609_MAX_SCALE * 6 * UC1609_MAX_SCALE];
+  uint8_t scale = _scale;
+  uint8_t cols = (fontWidth + 1) * scale;   // glyph and padding columns
+  uint8_t lead = (scale + 1) / 2;           // padding columns before the glyph
+  uint16_t bytes = cols * scale;
+  if (bytes > sizeof(buf)) return;
+
+  bool cacheable = _glyphCache && bytes <= UC1609_GLYPH_CACHE_BYTES;
+  uint8_t *cached = cacheable ? _glyphCache->find(glyph, scale, _antiAliasingEnable) : nullptr;
+  if (cached) {
+    memcpy(buf, cached, bytes);
+  }
+  else {
+    memset(buf, 0, bytes);
+    for (uint8_t x = 0; x < fontWidth; x++) {
+      uint8_t bits = readFontByte(glyph[x]);
+      for (uint8_t p = 0; p < scale; p++) {
+        uint8_t b = _scaledPage(bits, scale, p);
+        memset(&buf[p * cols + lead + x * scale], b, scale);
+      }
+    }
 
-    digitalWrite(_cd, LOW);
-    SPI.transfer(REG_COL_ADDR_L | (_ccol & 0x0F));
-    SPI.transfer(REG_COL_ADDR_H | (_ccol & 0xF0) >> 4);
-    SPI.transfer(REG_PAGE_ADDER | (_crow + 1));
-    digitalWrite(_cd, HIGH);
+    if (_antiAliasingEnable) {
+      for (uint8_t x = 0; x + 1 < fontWidth; x++) {
+        uint8_t a = readFontByte(glyph[x]);
+        uint8_t b = readFontByte(glyph[x + 1]);
+        uint8_t rising = ~a & (a >> 1) & b & ~(b >> 1) & 0x3F;   // a: 0 then 1, b: 1 then 0
+        uint8_t falling = a & ~(a >> 1) & ~b & (b >> 1) & 0x3F;  // a: 1 then 0, b: 0 then 1
+        uint8_t left = lead + (x + 1) * scale - 1;               // last column of source column x
+        for (uint8_t y = 0; y < 6; y++) {
+          if (!((rising | falling) >> y & 0x01)) continue;
+          uint8_t corner = (y + 1) * scale;                      // first row of the lower block
+          uint8_t upper = (rising >> y & 0x01) ? left : left + 1;
+          uint8_t lower = (rising >> y & 0x01) ? left + 1 : left;
+          int8_t dir = (upper == left) ? -1 : 1;                 // away from the boundary
+          for (uint8_t k = 0; k + 1 < scale; k++) {
+            for (uint8_t r = 1; r < scale - k; r++) {
+              _setPixel(buf, cols, upper + dir * k, corner - r);
+              _setPixel(buf, cols, lower - dir * k, corner + r - 1);
+            }
+          }
+        }
+      }
+    }
 
-    SPI.transfer(&buf[12], 12);  // padding at end of each font
-    digitalWrite(_cs, HIGH);
-    SPI.endTransaction();
+    if (cacheable) {
+      uint8_t *entry = _glyphCache->store(glyph, scale, _antiAliasingEnable);
+      if (entry) memcpy(entry, buf, bytes);
+    }
   }
 
-  _ccol += ((fontWidth * _scale) + _padding);
-  return 1;
+  _writeGlyphPages(buf, cols, scale);
+#else
+  (void) glyph;
+  (void) fontWidth;
+#endif
 }
 
 /*
- * Draws a bitmap image 
+ * Print a printable character 
+ * param: const char ch - ASCII value of the character
+ * return: 0 - failed, 1 - success
+ */
+size_t UC1609::write(uint8_t ch) {
+  return write(&ch, 1);
+}
+
+/*
+ * Print a buffer of characters in a single pass and a single SPI transaction. The
+ * glyph columns of consecutive characters on a line are packed into one data stream
+ * that relies on the column auto-increment of the controller, the address is only sent
+ * again after a line wrap or a control character ('\r', '\n', '\t', '\b') moves the
+ * cursor. A character that does not fit on the rest of the line is wrapped to the next.
+ * With a text buffer attached, text at scale 1 only updates the buffer, see setTextBuffer().
+ * param: const uint8_t *buffer - characters to be printed
+ *        size_t size - number of characters
+ * return: number of characters processed
+ */
+size_t UC1609::write(const uint8_t *buffer, size_t size) {
+  if (_textBuffer && _scale == 1)
+    return _writeText(buffer, size);
+
+  uint8_t fontWidth = readFontByte(_font[0]);
+  uint8_t fontStart = readFontByte(_font[2]);
+  uint8_t fontEnd = readFontByte(_font[3]);
+  uint8_t advance = fontWidth * _scale + _padding;
+
+  uint8_t stream[30];  // column bytes of up to 5 glyphs (fonts are 5 columns wide) waiting to be sent
+  uint8_t len = 0;
+
+  _beginTransfer();
+  for (size_t i = 0; i < size; i++) {
+    uint8_t ch = buffer[i];
+    bool control = (ch == '\r' || ch == '\n' || ch == '\t' || ch == '\b');
+    bool printable = !control && ch >= fontStart && ch <= fontEnd;
+
+    // anything but a glyph that continues the stream at the address pointer
+    // sends the pending stream first and is handled here
+    if (!(printable && _scale == 1 && _ccol + advance <= _width && len + advance <= sizeof(stream))) {
+      if (len) {
+        _writeData(stream, len);
+        len = 0;
+      }
+
+      switch (ch) {
+        case '\r':
+          _ccol = 0;
+          continue;
+        case '\n':
+          _newLine();
+          continue;
+        case '\t':
+          // tab = 4 spaces, stopping at the right edge (_ccol would overflow at scale 3
+          // and 4), the next character wraps
+          _ccol = (_ccol + 4 * advance < _width) ? _ccol + 4 * advance : _width;
+          continue;
+        case '\b':
+          // move the cursor back one space but does not delete the char in place
+          _ccol = (_ccol > advance) ? _ccol - advance : 0;
+          continue;
+        default:
+          if (!printable)
+            continue;
+      }
+
+      // wrap text to next line if the character does not fit on the current line
+      if (_ccol + advance > _width)
+        _newLine();
+
+      if (_scale != 1) {
+        if (_scale == 2)
+          _writeDoubleSize(&_font[(ch - fontStart) * fontWidth + 4], fontWidth);
+        else
+          _writeScaled(&_font[(ch - fontStart) * fontWidth + 4], fontWidth);
+        _ccol += advance;
+        continue;
+      }
+    }
+
+    // a new stream starts at the cursor, this sends nothing if the address pointer is there
+    if (len == 0)
+      _setAddress(_ccol, _crow);
+
+    const uint8_t *glyph = &_font[(ch - fontStart) * fontWidth + 4];
+    stream[len++] = 0x00; // padding col
+    for (uint8_t col = 0; col < fontWidth; col++) {
+      stream[len++] = readFontByte(glyph[col]);
+    }
+    _ccol += advance;
+  }
+
+  if (len)
+    _writeData(stream, len);
+  _endTransfer();
+
+  return size;
+}
+
+/*
+ * Estimate the bytes that write(ch) sends at the cursor: the glyph columns of all its
+ * pages at the current font scale with their address, and the line change when `ch` is a
+ * '\n' or does not fit on the line, which clears the display when the next line does not
+ * fit on the screen (or clears a line in console mode). At scale 1 glyphs continue the
+ * data stream, only a character that moves the cursor or wraps costs the address of the
+ * next one. Used by UC1609DrawQueue to cost text before drawing it.
+ * param: uint8_t ch - character to be printed
+ * return: estimated bytes
+ */
+uint16_t UC1609::writeCost(uint8_t ch) const {
+  if (_textBuffer && _scale == 1) return 0;   // only updates the text buffer
+
+  uint8_t fontWidth = readFontByte(_font[0]);
+  uint8_t advance = fontWidth * _scale + _padding;
+  bool control = ch == '\r' || ch == '\n' || ch == '\t' || ch == '\b';
+  bool printable = !control && ch >= readFontByte(_font[2]) && ch <= readFontByte(_font[3]);
+  bool wrap = printable && _ccol + advance > _width;
+  uint16_t cost = 0;
+
+  if (ch == '\n' || wrap) {
+    uint8_t row = _crow + _scale;
+    if (_console)
+      cost += (uint16_t) _width * _scale + 3 * _scale + 1;
+    else if (row + _scale > _height / 8)
+      cost += (uint16_t) _width * (_height / 8) + 3;   // clearDisplay()
+  }
+  if (printable)
+    cost += (_scale == 1) ? advance : advance * _scale + 3 * _scale;
+  if (_scale == 1 && (control || wrap))
+    cost += 3;
+  return cost;
+}
+
+/*
+ * Draws a bitmap image on page boundaries. Each page of the bitmap is written whole,
+ * including the rows beyond h in its last page, and clipped to the display once per
+ * page instead of per byte.
  * params: uint8_t x - position in x-axis where the image to be draw
- *         uint8_t y - position in y-axis where the image to be draw
+ *         uint8_t y - position in y-axis where the image to be draw, rounded down to a line
  *         uint8_t w - the width of the image
  *         uint8_t h - the height of the image
  *         uint8_t *data - pointer to the image bitmap array
  * return: void
  */
 void UC1609::drawImage(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* data) {
+  uint8_t page = y >> 3;
+  uint8_t pages = (h + 7) >> 3;
+  if (x >= _width || page >= UC1609_PAGES || w == 0 || !data) return;
+  if (pages > UC1609_PAGES - page) pages = UC1609_PAGES - page;
+  uint8_t visible = (w < _width - x) ? w : _width - x;   // columns of the image on the display
+  uint8_t chunk[32];
+
+  _beginTransfer();
+  for (uint8_t p = 0; p < pages; p++) {
+    const uint8_t *src = data + p * w;
+    _setAddress(x, page + p);
+    for (uint8_t col = 0; col < visible; ) {
+      uint8_t len = 0;
+      while (len < sizeof(chunk) && col < visible) chunk[len++] = readFontByte(src[col++]);
+      _writeData(chunk, len);
+    }
+  }
+  _endTransfer();
+}
 
-  uint8_t column = x;
+/*
+ * Draws an image compressed with extras/tools/uc1609_compress.py. The image is decoded
+ * straight into the data stream through a small chunk buffer, a run is sent as a block
+ * fill of the chunk, and the address is only sent again at the start of each page.
+ * Packets, after the width and height bytes of the image:
+ *   0x00-0x7F  n+1 literal bytes follow
+ *   0x80-0xBF  run of n+1 0x00 bytes
+ *   0xC0-0xFE  run of n+2 copies of the next byte
+ *   0xFF n v   run of n+1 copies of v
+ * params: uint8_t x - position in x-axis where the image to be draw
+ *         uint8_t y - position in y-axis where the image to be draw, rounded down to a line
+ *         uint8_t *data - pointer to the compressed image array
+ * return: void
+ */
+void UC1609::drawCompressedImage(uint8_t x, uint8_t y, const uint8_t *data) {
+  if (!data) return;
+  uint8_t w = readFontByte(data[0]);
+  uint8_t h = readFontByte(data[1]);
   uint8_t page = y >> 3;
-  
-  SPI.beginTransaction(SPISettings(SPI_CLOCK, MSBFIRST, SPI_MODE0));
-  digitalWrite(_cs, LOW);
-  for (uint8_t ty = 0; ty < h; ty = ty + 8) {
-    if (y + ty < 0 || y + ty >= _height)
-      continue;
-
-    digitalWrite(_cd, LOW);
-    SPI.transfer(REG_COL_ADDR_L | (column & 0x0F)); 
-    SPI.transfer(REG_COL_ADDR_H | ((column & 0xF0) >> 4));
-    SPI.transfer(REG_PAGE_ADDER | page++); 
-    digitalWrite(_cd, HIGH);
-
-    for (uint8_t tx = 0; tx < w; tx++) {
-      if (x + tx < 0 || x + tx >= _width)
-        continue;
-      SPI.transfer(readFontByte(data[(w * (ty >> 3)) + tx]));
+  uint8_t pages = (h + 7) >> 3;
+  if (x >= _width || page >= UC1609_PAGES || w == 0) return;
+  if (pages > UC1609_PAGES - page) pages = UC1609_PAGES - page;
+  uint8_t visible = (w < _width - x) ? w : _width - x;   // columns of the image on the display
+
+  const uint8_t *src = data + 2;
+  uint8_t col = 0;        // column within the image of the next decoded byte
+  uint8_t p = 0;
+  uint8_t chunk[32];
+  uint8_t len = 0;
+
+  _beginTransfer();
+  _setAddress(x, page);
+  while (p < pages) {
+    uint8_t c = readFontByte(*src++);
+    bool literal = c < 0x80;
+    uint16_t n;
+    uint8_t value = 0;
+    if (literal)
+      n = c + 1;
+    else if (c < 0xC0)
+      n = c - 0x80 + 1;
+    else if (c < 0xFF) {
+      n = c - 0xC0 + 2;
+      value = readFontByte(*src++);
+    }
+    else {
+      n = readFontByte(*src++) + 1;
+      value = readFontByte(*src++);
+    }
+
+    while (n && p < pages) {
+      uint8_t span = (n < (uint16_t) (w - col)) ? n : w - col;   // bytes up to the end of the page
+      uint8_t end = col + span;
+      n -= span;
+      while (col < end) {
+        if (col >= visible) {
+          if (literal) src += end - col;   // clipped columns
+          col = end;
+          break;
+        }
+        uint8_t k = ((end < visible) ? end : visible) - col;
+        if (k > sizeof(chunk) - len) k = sizeof(chunk) - len;
+        if (literal) {
+          for (uint8_t i = 0; i < k; i++)
+            chunk[len + i] = readFontByte(src[i]);
+          src += k;
+        }
+        else {
+          memset(&chunk[len], value, k);
+        }
+        len += k;
+        col += k;
+        if (len == sizeof(chunk)) {
+          _writeData(chunk, len);
+          len = 0;
+        }
+      }
+      if (col == w) {
+        if (len) {
+          _writeData(chunk, len);
+          len = 0;
+        }
+        col = 0;
+        if (++p < pages)
+          _setAddress(x, page + p);
+      }
     }
   }
-  digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
-  
+  if (len) _writeData(chunk, len);
+  _endTransfer();
+}
+
+/*
+ * Draws a bitmap at any pixel position, including partly or completely off-screen. The
+ * bitmap has the same page-major format as drawImage(), when y is not a multiple of 8
+ * each source byte is split across two display pages. The visible window is computed
+ * once, then each visible page is sent as one address command and one data stream.
+ * Modes:
+ *   SPRITE_OPAQUE      the rows y to y + h - 1 of the sprite replace the display content
+ *   SPRITE_TRANSPARENT only the set pixels of the sprite are drawn
+ *   SPRITE_MASKED      only the pixels set in `mask` (same format as data) are drawn
+ * The display RAM cannot be read back over SPI, so keeping the pixels around the sprite
+ * needs a framebuffer or strip (renderStrips()). Drawing directly on the display, all
+ * modes are drawn opaque and the pixels above and below the sprite in its first and
+ * last page are cleared, which is what erases the trail of a moving sprite.
+ * params: int16_t x - position in x-axis, can be negative
+ *         int16_t y - position in y-axis, can be negative
+ *         uint8_t w - the width of the sprite
+ *         uint8_t h - the height of the sprite
+ *         uint8_t *data - pointer to the sprite bitmap array
+ *         uint8_t mode - SPRITE_OPAQUE (default), SPRITE_TRANSPARENT or SPRITE_MASKED
+ *         uint8_t *mask - pointer to the mask bitmap array for SPRITE_MASKED
+ * return: void
+ */
+void UC1609::drawSprite(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *data,
+                        uint8_t mode, const uint8_t *mask) {
+  // visible window
+  int16_t x0 = (x < 0) ? 0 : x;
+  int16_t x1 = (x + w > _width) ? _width : x + w;
+  int16_t y0 = (y < 0) ? 0 : y;
+  int16_t y1 = (y + h > _height) ? _height : y + h;
+  if (x0 >= x1 || y0 >= y1 || !data) return;
+  if (mode == SPRITE_MASKED && !mask) mode = SPRITE_OPAQUE;
+
+  int16_t py = (y < 0) ? -((7 - y) >> 3) : (y >> 3);  // page of the first sprite row, rounded down
+  uint8_t shift = y - py * 8;                          // row of the first sprite row in that page
+  uint8_t srcPages = (h + 7) >> 3;
+  uint8_t chunk[32];
+
+  _beginTransfer();
+  for (uint8_t page = y0 >> 3; page <= (y1 - 1) >> 3; page++) {
+    // rows of this page covered by the sprite
+    int16_t top = y - page * 8;
+    int16_t bottom = top + h;
+    uint8_t cover = (top <= 0 ? 0xFF : (uint8_t) (0xFF << top)) & (bottom >= 8 ? 0xFF : (uint8_t) ~(0xFF << bottom));
+    int16_t k1 = page - py;         // source page drawn at bit `shift` of this page
+    int16_t k0 = k1 - 1;            // source page whose bottom spills into this page
+    bool hasK1 = k1 >= 0 && k1 < srcPages;
+    bool hasK0 = shift && k0 >= 0 && k0 < srcPages;
+    uint8_t ramPage = (page + _scrollPage) & (UC1609_PAGES - 1);
+
+    _setAddress(x0, page);
+    uint8_t len = 0;
+    for (int16_t col = x0; col < x1; col++) {
+      uint8_t sx = col - x;
+      uint8_t d = 0;
+      uint8_t m = 0;
+      if (hasK1) {
+        d |= readFontByte(data[k1 * w + sx]) << shift;
+        if (mode == SPRITE_MASKED) m |= readFontByte(mask[k1 * w + sx]) << shift;
+      }
+      if (hasK0) {
+        d |= readFontByte(data[k0 * w + sx]) >> (8 - shift);
+        if (mode == SPRITE_MASKED) m |= readFontByte(mask[k0 * w + sx]) >> (8 - shift);
+      }
+      d &= cover;
+      if (mode == SPRITE_OPAQUE) m = cover;
+      else if (mode == SPRITE_TRANSPARENT) m = d;
+      else m &= cover;
+
+      chunk[len++] = _ram ? (_readRam(col, ramPage) & ~m) | (d & m) : d;
+      if (len == sizeof(chunk)) {
+        _writeData(chunk, len);
+        len = 0;
+      }
+    }
+    if (len) _writeData(chunk, len);
+  }
+  _endTransfer();
+}
+
+/*
+ * Pixel drawing primitives. They work on the bytes of the RAM target directly, so they
+ * need a framebuffer (setFrameBuffer()) or strip rendering (renderStrips()) and do
+ * nothing when drawing directly on the display, which cannot be read back. Coordinates
+ * are signed and everything is clipped to the display. Each byte covers 8 rows of a
+ * page, so horizontal spans take one mask per byte, and vertical spans whole bytes with
+ * a mask for the first and last page.
+ * color: PIXEL_ON (default), PIXEL_OFF or PIXEL_INVERT
+ */
+
+/*
+ * Internal function applying `mask` in `color` to the columns x0 to x1 of a line of the
+ * screen in the RAM target.
+ */
+void UC1609::_maskSpan(int16_t x0, int16_t x1, uint8_t line, uint8_t mask, uint8_t color) {
+  if (!_ram || !mask || line >= UC1609_PAGES) return;
+  if (x0 < 0) x0 = 0;
+  if (x1 >= _width) x1 = _width - 1;
+  if (x0 > x1) return;
+  uint8_t page = (line + _scrollPage) & (UC1609_PAGES - 1);
+  uint8_t row = page - _ramFirst;
+  if (row >= _ramPages) return;
+
+  uint8_t *b = &_ram[row * _width + x0];
+  uint8_t n = x1 - x0 + 1;
+  if (color == PIXEL_ON)
+    while (n--) *b++ |= mask;
+  else if (color == PIXEL_OFF)
+    while (n--) *b++ &= ~mask;
+  else
+    while (n--) *b++ ^= mask;
+
+  if (_fb) {
+    if (x0 < _fb->dirtyStart[page]) _fb->dirtyStart[page] = x0;
+    if (x1 >= _fb->dirtyEnd[page]) _fb->dirtyEnd[page] = x1 + 1;
+  }
+}
+
+void UC1609::drawPixel(int16_t x, int16_t y, uint8_t color) {
+  if (y < 0 || y >= _height) return;
+  _maskSpan(x, x, y >> 3, 1 << (y & 0x07), color);
+}
+
+void UC1609::drawHLine(int16_t x, int16_t y, int16_t w, uint8_t color) {
+  if (y < 0 || y >= _height || w <= 0) return;
+  _maskSpan(x, x + w - 1, y >> 3, 1 << (y & 0x07), color);
+}
+
+void UC1609::drawVLine(int16_t x, int16_t y, int16_t h, uint8_t color) {
+  fillBox(x, y, 1, h, color);
+}
+
+/*
+ * Filled rectangle in pixels, see fillRect() for whole pages.
+ */
+void UC1609::fillBox(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
+  if (w <= 0 || h <= 0) return;
+  int16_t y0 = (y < 0) ? 0 : y;
+  int16_t y1 = (y + h > _height) ? _height - 1 : y + h - 1;
+  if (y0 > y1) return;
+
+  for (uint8_t line = y0 >> 3; line <= (y1 >> 3); line++) {
+    uint8_t mask = 0xFF;
+    if (line == (y0 >> 3)) mask &= 0xFF << (y0 & 0x07);
+    if (line == (y1 >> 3)) mask &= 0xFF >> (7 - (y1 & 0x07));
+    _maskSpan(x, x + w - 1, line, mask, color);
+  }
+}
+
+void UC1609::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
+  if (w <= 0 || h <= 0) return;
+  drawHLine(x, y, w, color);
+  if (h > 1) drawHLine(x, y + h - 1, w, color);
+  if (h > 2) {
+    drawVLine(x, y + 1, h - 2, color);
+    if (w > 1) drawVLine(x + w - 1, y + 1, h - 2, color);
+  }
+}
+
+/*
+ * Bresenham line. A shallow line is drawn as horizontal runs, one per row, and a steep
+ * line as vertical runs, one per column, that take one mask per page.
+ */
+void UC1609::drawSegment(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color) {
+  int16_t dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+  int16_t dy = (y1 > y0) ? y1 - y0 : y0 - y1;
+
+  if (dx >= dy) {
+    if (x0 > x1) {
+      int16_t t = x0; x0 = x1; x1 = t;
+      t = y0; y0 = y1; y1 = t;
+    }
+    int16_t sy = (y1 > y0) ? 1 : -1;
+    int16_t err = dx / 2;
+    int16_t runStart = x0;
+    for (int16_t x = x0; x <= x1; x++) {
+      err -= dy;
+      if (err < 0 || x == x1) {
+        drawHLine(runStart, y0, x - runStart + 1, color);
+        runStart = x + 1;
+        if (err < 0) {
+          y0 += sy;
+          err += dx;
+        }
+      }
+    }
+    return;
+  }
+
+  if (y0 > y1) {
+    int16_t t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+  }
+  int16_t sx = (x1 > x0) ? 1 : -1;
+  int16_t err = dy / 2;
+  int16_t runStart = y0;
+  for (int16_t y = y0; y <= y1; y++) {
+    err -= dx;
+    if (err < 0 || y == y1) {
+      drawVLine(x0, runStart, y - runStart + 1, color);
+      runStart = y + 1;
+      if (err < 0) {
+        x0 += sx;
+        err += dy;
+      }
+    }
+  }
+}
+
+/*
+ * Midpoint circle, the points on the diagonals are only drawn once so that
+ * PIXEL_INVERT leaves no holes.
+ */
+void UC1609::drawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color) {
+  if (r < 0) return;
+  if (r == 0) {
+    drawPixel(x0, y0, color);
+    return;
+  }
+  int16_t f = 1 - r;
+  int16_t ddx = 1;
+  int16_t ddy = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  drawPixel(x0, y0 + r, color);
+  drawPixel(x0, y0 - r, color);
+  drawPixel(x0 + r, y0, color);
+  drawPixel(x0 - r, y0, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddy += 2;
+      f += ddy;
+    }
+    x++;
+    ddx += 2;
+    f += ddx;
+    if (x > y) break;
+    drawPixel(x0 + x, y0 + y, color);
+    drawPixel(x0 - x, y0 + y, color);
+    drawPixel(x0 + x, y0 - y, color);
+    drawPixel(x0 - x, y0 - y, color);
+    if (x == y) break;
+    drawPixel(x0 + y, y0 + x, color);
+    drawPixel(x0 - y, y0 + x, color);
+    drawPixel(x0 + y, y0 - x, color);
+    drawPixel(x0 - y, y0 - x, color);
+  }
+}
+
+/*
+ * Filled circle made of vertical spans, each column is drawn once.
+ */
+void UC1609::fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color) {
+  if (r < 0) return;
+  int16_t f = 1 - r;
+  int16_t ddx = 1;
+  int16_t ddy = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+
+  drawVLine(x0, y0 - r, 2 * r + 1, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddy += 2;
+      f += ddy;
+    }
+    x++;
+    ddx += 2;
+    f += ddx;
+    if (x < y + 1) {
+      drawVLine(x0 + x, y0 - y, 2 * y + 1, color);
+      drawVLine(x0 - x, y0 - y, 2 * y + 1, color);
+    }
+    if (y != py) {
+      drawVLine(x0 + py, y0 - px, 2 * px + 1, color);
+      drawVLine(x0 - py, y0 - px, 2 * px + 1, color);
+      py = y;
+    }
+    px = x;
+  }
 }
 
 /*
@@ -399,3 +1562,324 @@ void UC1609::powerDown(void) {
   resetDisplay();
   enableDisplay(0);
 }
+
+/*
+ * Attach a RAM framebuffer. Once attached, all drawing functions only update the
+ * framebuffer and record the changed column span of each page, nothing is sent to
+ * the panel until flush() is called. The framebuffer is cleared and assumed to match
+ * the panel (i.e. call it after begin() or clearDisplay()).
+ * param:  UC1609FrameBuffer *fb - framebuffer, or nullptr to draw directly to the panel again
+ * return: void
+ */
+void UC1609::setFrameBuffer(UC1609FrameBuffer *fb) {
+  _waitAsync();
+  if (_async) _async->back = nullptr;
+  _fb = fb;
+  _ram = nullptr;
+  if (!_fb) return;
+  memset(_fb->ram, 0, sizeof(_fb->ram));
+  memset(_fb->dirtyStart, _width, sizeof(_fb->dirtyStart));
+  memset(_fb->dirtyEnd, 0, sizeof(_fb->dirtyEnd));
+  _ram = &_fb->ram[0][0];
+  _ramFirst = 0;
+  _ramPages = UC1609_PAGES;
+  _ramCol = 0;
+  _ramPage = 0;
+}
+
+/*
+ * Send the dirty spans of the framebuffer to the panel, one address command and one
+ * contiguous data burst per dirty page, all within a single SPI transaction. In console
+ * mode a scroll of the screen is only sent here, after the lines it brings in.
+ * Does nothing if no framebuffer is attached.
+ * param:  void
+ * return: void
+ */
+void UC1609::flush() {
+  if (!_fb) return;
+
+  UC1609FrameBuffer *fb = _fb;
+  _fb = nullptr;               // route the output below to the panel
+  _ram = nullptr;
+  bool claimed = false;
+  for (uint8_t page = 0; page < UC1609_PAGES; page++) {
+    uint8_t start = fb->dirtyStart[page];
+    uint8_t end = fb->dirtyEnd[page];
+    if (start >= end) continue;
+    if (!claimed) {
+      _beginTransfer();
+      claimed = true;
+    }
+    _setRamAddress(start, page);
+    for (uint8_t col = start; col < end; col++) {
+      _writeData(fb->ram[page][col]);
+    }
+    if (_async && _async->back)
+      memcpy(&_async->back->ram[page][start], &fb->ram[page][start], end - start);
+    fb->dirtyStart[page] = _width;
+    fb->dirtyEnd[page] = 0;
+  }
+  if (claimed) _endTransfer();
+  if (_scrollPending) {
+    scroll(_scrollPage * 8);
+    _scrollPending = false;
+  }
+  _fb = fb;
+  _ram = &fb->ram[0][0];
+}
+
+/*
+ * return: true if the framebuffer holds drawing that flush() has not sent yet
+ */
+bool UC1609::isDirty() const {
+  if (!_fb) return false;
+  for (uint8_t page = 0; page < UC1609_PAGES; page++) {
+    if (_fb->dirtyStart[page] < _fb->dirtyEnd[page]) return true;
+  }
+  return _scrollPending;
+}
+
+/*
+ * Attach the state of flushAsync(), which is cleared. setBackBuffer() and
+ * setAsyncBackend() keep their settings in it and are called after it.
+ * param: UC1609AsyncState *state - the state, or nullptr to release it (flushAsync() then
+ *                                  returns false)
+ */
+void UC1609::setAsyncState(UC1609AsyncState *state) {
+  _waitAsync();
+  _async = state;
+  if (_async) memset(_async, 0, sizeof(*_async));
+}
+
+/*
+ * Attach a second framebuffer for double buffering with flushAsync(). It receives a copy
+ * of the framebuffer, and each flushAsync() then swaps the two: drawing continues in one
+ * while the other is being sent, so the next frame can be prepared during the transfer.
+ * Only the dirty spans are copied between the buffers at each swap.
+ * param: UC1609FrameBuffer *back - the second framebuffer, or nullptr for single buffering
+ */
+void UC1609::setBackBuffer(UC1609FrameBuffer *back) {
+  if (!_async) return;
+  _waitAsync();
+  _async->back = _fb ? back : nullptr;
+  if (!back || !_fb) return;
+  memcpy(back->ram, _fb->ram, sizeof(_fb->ram));
+  memset(back->dirtyStart, _width, sizeof(back->dirtyStart));
+  memset(back->dirtyEnd, 0, sizeof(back->dirtyEnd));
+}
+
+/*
+ * Select the back-end that sends the data bursts of flushAsync(), e.g. with DMA.
+ * param: UC1609AsyncBackend *backend - the back-end, or nullptr to send them from service()
+ */
+void UC1609::setAsyncBackend(UC1609AsyncBackend *backend) {
+  if (!_async) return;
+  _waitAsync();
+  _async->backend = backend;
+}
+
+/*
+ * Start sending the dirty spans of the framebuffer without waiting for them. Each dirty
+ * page becomes a transfer descriptor, which is sent by the back-end, or by service() in
+ * steps of a few bytes, to be called from loop(). isBusy() is true until the last byte is
+ * sent, then the `done` callback is called from service(). Drawing can go on meanwhile:
+ * with a back buffer (setBackBuffer()) it goes to the other framebuffer, otherwise it
+ * changes the framebuffer being sent and the changes are sent by the next flush. Any other
+ * output to the display first waits for the transfer to complete.
+ * param: UC1609CompleteCallback done - called when the transfer is complete, or nullptr
+ * return: false if the previous transfer is still in progress, or there is no framebuffer or
+ *         state (setAsyncState())
+ */
+bool UC1609::flushAsync(UC1609CompleteCallback done) {
+  if (!_fb || !_async || _async->count) return false;
+
+  UC1609AsyncState &a = *_async;
+  UC1609FrameBuffer *fb = _fb;
+  uint8_t count = 0;
+  for (uint8_t page = 0; page < UC1609_PAGES; page++) {
+    uint8_t start = fb->dirtyStart[page];
+    uint8_t end = fb->dirtyEnd[page];
+    if (start >= end) continue;
+    a.xfer[count].data = &fb->ram[page][start];
+    a.xfer[count].page = page;
+    a.xfer[count].col = start;
+    a.xfer[count].len = end - start;
+    count++;
+    if (a.back)
+      memcpy(&a.back->ram[page][start], &fb->ram[page][start], end - start);
+    fb->dirtyStart[page] = _width;
+    fb->dirtyEnd[page] = 0;
+  }
+  if (a.back) {
+    _fb = a.back;
+    a.back = fb;
+    _ram = &_fb->ram[0][0];
+  }
+
+  a.count = count;
+  a.index = 0;
+  a.sent = 0;
+  a.scroll = _scrollPending;
+  _scrollPending = false;
+  a.onComplete = done;
+  if (count == 0)
+    _finishAsync();
+  else if (a.backend)
+    _startTransfer();
+  return true;
+}
+
+/*
+ * Advance the transfer of flushAsync(), to be called from loop(). Without a back-end it
+ * sends up to maxBytes bytes in one SPI transaction, so the time spent here is bounded
+ * (maxBytes x 1us at 8MHz). With a back-end it starts the next burst once the previous
+ * one is done. It calls the completion callback after the last burst.
+ * param: uint16_t maxBytes - data bytes to send at most (default UC1609_ASYNC_CHUNK)
+ * return: data bytes sent by this call, 0 with a back-end
+ */
+uint16_t UC1609::service(uint16_t maxBytes) {
+  if (!isBusy()) return 0;
+
+  UC1609AsyncState &a = *_async;
+  if (a.backend) {
+    if (a.busy) return 0;
+    _inService = true;
+    _releaseBus();
+    _inService = false;
+    if (++a.index < a.count)
+      _startTransfer();
+    else
+      _finishAsync();
+    return 0;
+  }
+
+  uint16_t budget = maxBytes;
+  uint8_t *ram = _ram;
+  _ram = nullptr;              // route the output below to the panel
+  _inService = true;
+  _claimBus();
+  while (maxBytes && a.index < a.count) {
+    UC1609Transfer &t = a.xfer[a.index];
+    if (a.sent == 0) _setRamAddress(t.col, t.page);
+    while (maxBytes && a.sent < t.len) {
+      _writeData(t.data[a.sent++]);
+      maxBytes--;
+    }
+    if (a.sent == t.len) {
+      a.index++;
+      a.sent = 0;
+    }
+  }
+  _releaseBus();
+  _inService = false;
+  _ram = ram;
+  if (a.index == a.count) _finishAsync();
+  return budget - maxBytes;
+}
+
+/*
+ * Internal function handing the current transfer descriptor to the back-end. The bus
+ * stays claimed until service() sees that the back-end is done.
+ */
+void UC1609::_startTransfer() {
+  UC1609Transfer &t = _async->xfer[_async->index];
+  uint8_t *ram = _ram;
+  _ram = nullptr;
+  _inService = true;
+  _claimBus();
+  _setRamAddress(t.col, t.page);
+  _sendCommands();
+  _dataMode();
+  _advanceAddress(t.len);
+  _async->busy = true;
+  _inService = false;
+  _ram = ram;
+  _async->backend->start(t.data, t.len);
+}
+
+void UC1609::_finishAsync() {
+  _async->count = 0;
+  if (_async->scroll) {
+    _async->scroll = false;
+    scroll(_scrollPage * 8);
+  }
+  if (_async->onComplete) {
+    UC1609CompleteCallback done = _async->onComplete;
+    _async->onComplete = nullptr;
+    done(*this);
+  }
+}
+
+/*
+ * Internal function completing a pending flushAsync() before other output.
+ */
+void UC1609::_waitAsync() {
+  while (isBusy()) {
+    service(UC1609_ASYNC_CHUNK);
+    yield();
+  }
+}
+
+/*
+ * Render the screen in horizontal strips of `pages` pages with a strip buffer of
+ * pages x 192 bytes, for full graphics (overlapping text, lines, images) without a
+ * framebuffer. The draw callback is called once per strip, from the same cursor
+ * position every time, and draws the whole screen; whatever falls outside of the
+ * current strip is dropped. Each strip is then sent in one data stream. A taller strip
+ * takes more RAM and fewer passes, e.g. 1 page (192 bytes) takes 8 passes, 4 pages
+ * (768 bytes) take 2. With a framebuffer attached, the callback draws into the
+ * framebuffer once and it is flushed. Not to be used together with the console mode.
+ * param:  uint8_t *strip - strip buffer of pages * 192 bytes
+ *         uint8_t pages - 1-8 pages per strip
+ *         UC1609DrawCallback draw - function drawing the screen, void draw(UC1609 &lcd)
+ * return: void
+ */
+void UC1609::renderStrips(uint8_t *strip, uint8_t pages, UC1609DrawCallback draw) {
+  if (!draw) return;
+  if (_fb) {
+    draw(*this);
+    flush();
+    return;
+  }
+  if (!strip || pages == 0) return;
+
+  uint8_t crow = _crow;
+  uint8_t ccol = _ccol;
+  for (uint8_t first = 0; first < UC1609_PAGES; first += pages) {
+    uint8_t n = (pages < UC1609_PAGES - first) ? pages : UC1609_PAGES - first;
+    memset(strip, 0, n * _width);
+    _ram = strip;
+    _ramFirst = first;
+    _ramPages = n;
+    _ramCol = 0;
+    _ramPage = first;
+    _crow = crow;
+    _ccol = ccol;
+    draw(*this);
+
+    _ram = nullptr;
+    _beginTransfer();
+    for (uint8_t p = 0; p < n; p++) {
+      _setRamAddress(0, first + p);   // nothing to send after the first page, the pointer rolls over
+      _writeData(&strip[p * _width], _width);
+    }
+    _endTransfer();
+  }
+}
+
+/*
+ * Claim the SPI bus and keep CS asserted until the matching endBatch(), so that any
+ * sequence of write(), setCursor(), drawLine(), drawImage(), etc. is sent in a single
+ * SPI transaction, only the CD pin toggles between commands and data. Calls can be
+ * nested, the bus is released by the outermost endBatch(). Other devices on the same
+ * SPI bus cannot be accessed inside a batch. See also the UC1609Batch scope guard.
+ * param:  void
+ * return: void
+ */
+void UC1609::beginBatch() {
+  _claimBus();
+}
+
+void UC1609::endBatch() {
+  _releaseBus();
+}
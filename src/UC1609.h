@@ -14,17 +14,13 @@
 
 #ifdef __AVR__
 #include <avr/io.h>
-#include <avr/pgmspace.h>
-#define FlashMem(n) const uint8_t PROGMEM n[]
-#define IMAGE(imgN) const uint8_t PROGMEM imgN[]
-#define readFontByte(addr) pgm_read_byte(&addr)
-#else
-#define FlashMem(n) const uint8_t n[]
-#define IMAGE(imgN) const uint8_t imgN[]
-#define readFontByte(addr) (addr)
 #endif
 
+#include "UC1609Flash.h"
 #include "fonts.h"
+#include "UC1609DoubleSize.h"
+#include "UC1609GlyphCache.h"
+#include "UC1609TextBuffer.h"
 
 // UC1609 registers
 #define REG_COL_ADDR_L      0x00 // Column Address Set CA [3:0]
@@ -52,6 +48,28 @@
 #define NORMAL_ORIENTATION  0x04
 #define ROTATE_UPSIDE_DOWN  0x02
 
+// UC1609 Frame rate (setFrameRate)
+#define FRAME_RATE_76       0
+#define FRAME_RATE_95       1    // default
+#define FRAME_RATE_132      2
+#define FRAME_RATE_168      3
+
+// UC1609 Bias ratio (setBiasRatio)
+#define BIAS_RATIO_6        0
+#define BIAS_RATIO_7        1
+#define BIAS_RATIO_8        2
+#define BIAS_RATIO_9        3    // default
+
+// drawSprite() modes
+#define SPRITE_OPAQUE       0    // the sprite box replaces the display content
+#define SPRITE_TRANSPARENT  1    // only set pixels of the sprite are drawn
+#define SPRITE_MASKED       2    // pixels set in the mask bitmap are drawn
+
+// pixel colors of the drawing primitives
+#define PIXEL_OFF           0
+#define PIXEL_ON            1
+#define PIXEL_INVERT        2
+
 // UC1609 Display Enable
 #define DISPLAY_ON          1
 #define DISPLAY_OFF         0
@@ -61,6 +79,97 @@
 #define SPI_CLOCK          8000000UL  // 8MHz
 #endif
 
+// CS and CD are toggled by writing the port registers directly on AVR, define
+// UC1609_NO_FAST_PINIO to always use digitalWrite()
+#if defined(__AVR__) && !defined(UC1609_NO_FAST_PINIO)
+#define UC1609_FAST_PINIO
+#endif
+
+// Largest font scale accepted by setFontScale(), from 2 to 8. Each step above 2 adds 64 bytes
+// of flash for the bit expansion table and 6 x scale x scale bytes of stack to write().
+#ifndef UC1609_MAX_SCALE
+#define UC1609_MAX_SCALE    4
+#endif
+
+// capacity of the command queue, see beginCommands(), 0 sends each command right away
+#ifndef UC1609_COMMAND_QUEUE
+#define UC1609_COMMAND_QUEUE 16
+#endif
+
+// bytes sent per service() step of a polled asynchronous flush, see flushAsync()
+#ifndef UC1609_ASYNC_CHUNK
+#define UC1609_ASYNC_CHUNK  64
+#endif
+
+// value of a controller register that is not known to the driver
+#define UC1609_UNKNOWN      0xFF
+
+// Display geometry
+#define UC1609_COLUMNS      192
+#define UC1609_PAGES        8
+
+/*
+ * Optional RAM framebuffer, see UC1609::setFrameBuffer(). Each page keeps the span
+ * of columns [dirtyStart, dirtyEnd) that differs from the panel, a page is clean when
+ * dirtyStart >= dirtyEnd.
+ */
+struct UC1609FrameBuffer {
+  uint8_t ram[UC1609_PAGES][UC1609_COLUMNS];
+  uint8_t dirtyStart[UC1609_PAGES];
+  uint8_t dirtyEnd[UC1609_PAGES];
+};
+
+class UC1609;
+
+// draw callback of UC1609::renderStrips(), called once per strip
+typedef void (*UC1609DrawCallback)(UC1609 &lcd);
+
+// completion callback of UC1609::flushAsync()
+typedef void (*UC1609CompleteCallback)(UC1609 &lcd);
+
+/*
+ * Descriptor of one data burst of UC1609::flushAsync(): `len` bytes of the framebuffer
+ * sent from column `col` of display RAM page `page`.
+ */
+struct UC1609Transfer {
+  const uint8_t *data;
+  uint8_t page;
+  uint8_t col;
+  uint8_t len;
+};
+
+/*
+ * Back-end of UC1609::flushAsync() for DMA or interrupt-driven SPI. start() is called
+ * with the SPI transaction begun, CS asserted, the address sent and CD high, and sends
+ * `len` bytes in the background. When done, the back-end calls UC1609::transferDone(),
+ * which is safe to call from an interrupt. Without a back-end, the bytes are sent by
+ * UC1609::service().
+ */
+class UC1609AsyncBackend {
+  public:
+    virtual void start(const uint8_t *data, uint8_t len) = 0;
+};
+
+/*
+ * State of UC1609::flushAsync(), provided by the application like the framebuffer, see
+ * UC1609::setAsyncState(), so a display that is never flushed asynchronously does not
+ * carry it. It takes 51 bytes of RAM on AVR.
+ */
+struct UC1609AsyncState {
+  UC1609Transfer xfer[UC1609_PAGES];
+  UC1609FrameBuffer *back;            // second framebuffer of setBackBuffer()
+  UC1609AsyncBackend *backend;
+  UC1609CompleteCallback onComplete;
+  uint8_t count;                      // the bursts xfer[index..count) are not sent yet
+  uint8_t index;
+  uint8_t sent;                       // bytes of xfer[index] sent by service()
+  volatile bool busy;                 // a back-end burst is in flight
+  bool scroll;
+};
+
+class UC1609BusDevice;
+class UC1609Transport;
+
 class UC1609: public Print {
   public:
     using Print::write;
@@ -72,37 +181,180 @@ class UC1609: public Print {
     void enableDisplay(uint8_t onOff);
     void clearDisplay();
     void setCursor(uint8_t col, uint8_t line);
+    uint8_t cursorCol() const { return _ccol; }
+    uint8_t cursorLine() const { return _crow; }
     void drawLine(uint8_t line, uint8_t dataPattern);    
     void clearLine(uint8_t line);
+    void fillRect(uint8_t x, uint8_t page, uint8_t w, uint8_t pages, uint8_t pattern);
     void scroll(uint8_t yPixel);
+    void setConsoleMode(bool enable);
     void rotate(uint8_t rotateValue);
     void invert(bool invert);
+    void setContrast(uint8_t VbiasPot);
+    void setFrameRate(uint8_t frameRate);
+    void setBiasRatio(uint8_t biasRatio);
+    void setTempCompensation(uint8_t tempComp);
+    void beginCommands();
+    void commit();
     void setFont(const uint8_t * font);
     void setFontScale(uint8_t scale);
     void setAntiAliasing(bool enable);
+    void setDoubleSizeFont(const uint8_t * table);
+    void setGlyphCache(UC1609GlyphCache *cache);
+    void setTextBuffer(UC1609TextBuffer *textBuffer);
+    void refresh();
     size_t write(uint8_t ch);
+    size_t write(const uint8_t *buffer, size_t size);
+    uint16_t writeCost(uint8_t ch) const;
     void drawImage(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* data);
+    void drawCompressedImage(uint8_t x, uint8_t y, const uint8_t *data);
+    void drawPixel(int16_t x, int16_t y, uint8_t color = PIXEL_ON);
+    void drawHLine(int16_t x, int16_t y, int16_t w, uint8_t color = PIXEL_ON);
+    void drawVLine(int16_t x, int16_t y, int16_t h, uint8_t color = PIXEL_ON);
+    void drawSegment(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color = PIXEL_ON);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color = PIXEL_ON);
+    void fillBox(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color = PIXEL_ON);
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color = PIXEL_ON);
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color = PIXEL_ON);
+    void drawSprite(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *data,
+                    uint8_t mode = SPRITE_OPAQUE, const uint8_t *mask = nullptr);
     void powerDown(void);
+    void setFrameBuffer(UC1609FrameBuffer *fb);
+    void flush();
+    void setAsyncState(UC1609AsyncState *state);
+    UC1609AsyncState *asyncState() const { return _async; }
+    void setBackBuffer(UC1609FrameBuffer *back);
+    void setAsyncBackend(UC1609AsyncBackend *backend);
+    bool flushAsync(UC1609CompleteCallback done = nullptr);
+    uint16_t service(uint16_t maxBytes = UC1609_ASYNC_CHUNK);
+    bool isBusy() const { return _async && _async->count != 0; }
+    bool isDirty() const;
+    void transferDone() { if (_async) _async->busy = false; }
+    void renderStrips(uint8_t *strip, uint8_t pages, UC1609DrawCallback draw);
+    void beginBatch();
+    void endBatch();
+    void setBusDevice(UC1609BusDevice *device) { _busDevice = device; }
+    void setTransport(UC1609Transport *transport) { _transport = transport; }
+    UC1609Transport *transport() const { return _transport; }
+    bool isBusClaimed() const { return _claimDepth != 0; }
+    void setSpiClock(uint32_t clock);
+    uint32_t spiClock() const { return _spiClock; }
 
   private:
+#ifdef UC1609_BENCH
+    friend struct UC1609Bench;   // host bench (extras/emulator) timing the private kernels
+#endif
     const uint8_t _width{192};
     const uint8_t _height{64};
     const uint8_t * _font{font5x7};
+    const uint8_t * _font2x{nullptr};  // pre-stretched double-size table of _font
+    UC1609GlyphCache * _glyphCache{nullptr};
+    UC1609TextBuffer * _textBuffer{nullptr};
     
     int8_t _cs;
     int8_t _cd;
     int8_t _rst;
+#ifdef UC1609_FAST_PINIO
+    volatile uint8_t *_csPort;
+    volatile uint8_t *_cdPort;
+    uint8_t _csMask;
+    uint8_t _cdMask;
+#endif
 
-    uint8_t _VbiasPOT; // Contrast DEFAULT_VBIAS_POT(0x49), datasheet 00-FE
+    uint8_t _VbiasPOT; // Contrast DEFAULT_VBIAS_POT(0x49), datasheet 00-FE, UC1609_UNKNOWN after a reset
     uint8_t _scale;
     uint8_t _padding;
     bool _antiAliasingEnable;
     uint8_t _crow;    // cursor row
     uint8_t _ccol;    // cursor column
+    UC1609FrameBuffer *_fb{nullptr};
+
+    // RAM target of the drawing functions (framebuffer or strip), nullptr for the panel
+    uint8_t *_ram{nullptr};
+    uint8_t _ramFirst;    // display RAM page held in _ram[0]
+    uint8_t _ramPages;
+    uint8_t _ramCol;      // address pointer of the RAM target
+    uint8_t _ramPage;
+    uint8_t _claimDepth{0};
+    uint32_t _spiClock{SPI_CLOCK};
+    SPISettings _spiSettings{SPI_CLOCK, MSBFIRST, SPI_MODE0};   // built once, not per transaction
+    UC1609BusDevice *_busDevice{nullptr};  // claims the bus through a UC1609Bus arbiter
+    UC1609Transport *_transport{nullptr};  // sends the bytes instead of the global SPI object
+
+    // shadow of the controller state, UC1609_UNKNOWN until set by begin()
+    uint8_t _hwCol{UC1609_UNKNOWN};       // address pointer, display RAM column
+    uint8_t _hwPage{UC1609_UNKNOWN};      // address pointer, display RAM page
+    uint8_t _hwScroll{UC1609_UNKNOWN};
+    uint8_t _hwMapping{UC1609_UNKNOWN};
+    uint8_t _hwInverse{UC1609_UNKNOWN};
+    uint8_t _hwAllPixelOn{UC1609_UNKNOWN};
+    uint8_t _hwFrameRate{UC1609_UNKNOWN};
+    uint8_t _hwBiasRatio{UC1609_UNKNOWN};
+    uint8_t _hwTempComp{UC1609_UNKNOWN};
+
+#if UC1609_COMMAND_QUEUE > 0
+    uint8_t _cmdQueue[UC1609_COMMAND_QUEUE];  // command bytes waiting to be sent
+#endif
+    uint8_t _cmdCount{0};
+    bool _holdCommands{false};                // inside beginCommands()/commit()
+
+    bool _console{false};
+    uint8_t _scrollPage{0};     // console mode: display RAM page shown on line 0
+    bool _scrollPending{false}; // console mode: scroll line not sent yet (framebuffer mode)
+
+    UC1609AsyncState *_async{nullptr};   // state of flushAsync(), see setAsyncState()
+    bool _inService{false};
     
+    void _csLow();
+    void _csHigh();
+    void _commandMode();
+    void _dataMode();
     void _sendCommand(uint8_t reg, uint8_t value);
+    void _claimBus();
+    void _releaseBus();
+    void _beginTransfer();
+    void _endTransfer();
+    void _setAddress(uint8_t col, uint8_t page);
+    void _setRamAddress(uint8_t col, uint8_t page);
+    bool _addressAt(uint8_t col, uint8_t line);
+    uint8_t _readRam(uint8_t col, uint8_t page);
+    void _maskSpan(int16_t x0, int16_t x1, uint8_t line, uint8_t mask, uint8_t color);
+    void _sendCommandIfChanged(uint8_t reg, uint8_t value, uint8_t &shadow);
+    void _queueCommand(uint8_t cmd);
+    void _sendCommands();
+    void _writeData(uint8_t data);
+    void _writeData(uint8_t *buf, uint8_t len);
+    void _advanceAddress(uint16_t len);
+    void _startTransfer();
+    void _finishAsync();
+    void _waitAsync();
     uint16_t _stretch(uint8_t x);
     void _antiAliasing(uint8_t *array);
+    void _newLine();
+    void _writeDoubleSize(const uint8_t *glyph, uint8_t fontWidth);
+    void _writeScaled(const uint8_t *glyph, uint8_t fontWidth);
+    void _writeGlyphPages(uint8_t *buf, uint8_t cols, uint8_t pages);
+    size_t _writeText(const uint8_t *buffer, size_t size);
+};
+
+/*
+ * Scope guard for UC1609::beginBatch()/endBatch(), the bus is claimed for the
+ * lifetime of the guard:
+ *   {
+ *     UC1609Batch batch(lcd);
+ *     lcd.setCursor(0, 0);
+ *     lcd.print("Hello");
+ *   }
+ */
+class UC1609Batch {
+  public:
+    UC1609Batch(UC1609 &lcd): _lcd(lcd) { _lcd.beginBatch(); }
+    ~UC1609Batch() { _lcd.endBatch(); }
+    UC1609Batch(const UC1609Batch &) = delete;
+    UC1609Batch &operator=(const UC1609Batch &) = delete;
+
+  private:
+    UC1609 &_lcd;
 };
 
 #endif
@@ -0,0 +1,96 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional animation player for the UC1609 library, see UC1609Animation.h.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include "UC1609Animation.h"
+
+/*
+ * Draw the keyframe of an animation and start playing it.
+ * param: const uint8_t *data - animation created with extras/tools/uc1609_anim.py
+ *        uint8_t x, y - position of the animation, y is rounded down to a line
+ *        uint16_t frameInterval - time between two frames in ms
+ *        bool loop - start again after the last frame, otherwise stop on it
+ */
+void UC1609Animation::begin(const uint8_t *data, uint8_t x, uint8_t y, uint16_t frameInterval, bool loop) {
+  _data = data;
+  _x = x;
+  _y = y & 0xF8;
+  _interval = frameInterval;
+  _loop = loop;
+  _frame = 0;
+  _next = _firstFrame();
+  _lcd.drawCompressedImage(_x, _y, _data + 6);
+  _lastFrame = millis();
+  _running = true;
+}
+
+/*
+ * Number of different frames, including the keyframe.
+ */
+uint8_t UC1609Animation::frames() const {
+  if (!_data) return 0;
+  return readFontByte(_data[2]) + 1 - (readFontByte(_data[3]) & 0x01);
+}
+
+const uint8_t *UC1609Animation::_firstFrame() const {
+  return _data + 6 + readFontByte(_data[4]) + (readFontByte(_data[5]) << 8);
+}
+
+/*
+ * Draw the next frame when it is due, to be called from loop(). A frame is never
+ * skipped as each frame only holds the changes from the one before, after a long
+ * delay the schedule restarts from now instead of catching up.
+ * return: true if a frame was drawn
+ */
+bool UC1609Animation::update() {
+  if (!_running) return false;
+  uint32_t now = millis();
+  uint32_t elapsed = now - _lastFrame;
+  if (elapsed < _interval) return false;
+  _lastFrame = (elapsed >= 2 * (uint32_t) _interval) ? now : _lastFrame + _interval;
+  drawFrame();
+  return true;
+}
+
+/*
+ * Draw the next frame now. The runs of a frame are sent in one SPI transaction, each
+ * with one address and one data stream.
+ */
+void UC1609Animation::drawFrame() {
+  if (!_data) return;
+  uint8_t count = frames();
+  bool wraps = readFontByte(_data[3]) & 0x01;
+
+  if (_frame + 1 >= count) {
+    if (!_loop) {
+      _running = false;
+      return;
+    }
+    if (!wraps) {
+      _lcd.drawCompressedImage(_x, _y, _data + 6);
+      _frame = 0;
+      _next = _firstFrame();
+      return;
+    }
+    // otherwise the next frame leads back to the keyframe
+  }
+
+  uint8_t runs = readFontByte(*_next++);
+  _lcd.beginBatch();
+  while (runs--) {
+    uint8_t page = readFontByte(_next[0]);
+    uint8_t col = readFontByte(_next[1]);
+    uint8_t len = readFontByte(_next[2]);
+    _lcd.drawSprite(_x + col, _y + page * 8, len, 8, _next + 3);
+    _next += 3 + len;
+  }
+  _lcd.endBatch();
+
+  if (++_frame == count) {
+    _frame = 0;
+    _next = _firstFrame();
+  }
+}
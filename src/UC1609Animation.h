@@ -0,0 +1,57 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional animation player for the UC1609 library. An animation is a keyframe
+ *               followed by frames that only hold the runs of bytes that differ from the frame
+ *               before, so each frame costs what changed on the screen instead of a full
+ *               drawImage(). Animations are created from image files with
+ *               extras/tools/uc1609_anim.py. Frames are drawn by update() at a fixed interval,
+ *               driven by millis() from loop().
+ *
+ *               #include "UC1609Animation.h"
+ *               UC1609Animation player(lcd);
+ *               player.begin(bootAnimation, 48, 16, 100, true);  // 10 frames per second, looping
+ *               void loop() { player.update(); }
+ *
+ *               Format (all bytes, in flash):
+ *                 width, height, number of frames after the keyframe, flags (bit 0: the last
+ *                 frame leads back to the keyframe), keyframe size (2 bytes, LSB first),
+ *                 keyframe in the format of drawCompressedImage(), then for each frame:
+ *                 number of runs, and for each run: page, column, length, `length` bytes
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_ANIMATION_H
+#define UC1609_ANIMATION_H
+
+#include "UC1609.h"
+
+class UC1609Animation {
+  public:
+    UC1609Animation(UC1609 &lcd): _lcd(lcd) {}
+
+    void begin(const uint8_t *data, uint8_t x, uint8_t y, uint16_t frameInterval, bool loop = false);
+    bool update();
+    void drawFrame();
+    void stop() { _running = false; }
+
+    bool isRunning() const { return _running; }
+    uint8_t frame() const { return _frame; }
+    uint8_t frames() const;
+
+  private:
+    UC1609 &_lcd;
+    const uint8_t *_data{nullptr};
+    const uint8_t *_next{nullptr};  // runs of the next frame
+    uint8_t _x{0};
+    uint8_t _y{0};
+    uint8_t _frame{0};              // frame on the display, 0 for the keyframe
+    uint16_t _interval{0};
+    uint32_t _lastFrame{0};
+    bool _loop{false};
+    bool _running{false};
+
+    const uint8_t *_firstFrame() const;
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional arbiter for several UC1609 panels and other devices on one SPI bus, see UC1609Bus.h.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include "UC1609Bus.h"
+#include "UC1609Transport.h"
+
+/*
+ * Register a device with the bus.
+ * param: UC1609Bus &bus - the bus the device is on
+ *        uint8_t priority - devices with a higher priority are served first
+ *        uint32_t clock, uint8_t bitOrder, uint8_t dataMode - SPI settings of the device
+ */
+UC1609BusDevice::UC1609BusDevice(UC1609Bus &bus, uint8_t priority, uint32_t clock, uint8_t bitOrder, uint8_t dataMode):
+  _bus(bus), _settings(clock, bitOrder, dataMode), _priority(priority) {
+  _bus._attach(this);
+}
+
+/*
+ * A device that is destroyed leaves the bus. A device that overrides holding() calls
+ * detach() in its own destructor, where its finish() can still run.
+ */
+UC1609BusDevice::~UC1609BusDevice() {
+  detach();
+}
+
+/*
+ * Take the device off the bus, after it has finished what it keeps the bus for and its
+ * transaction is ended. It can still claim() the bus for a direct access.
+ */
+void UC1609BusDevice::detach() {
+  if (_bus._open == this) {
+    if (holding()) finish();
+    _bus._close();
+  }
+  _bus._detach(this);
+}
+
+/*
+ * Begin the SPI transaction of the device, ending the one of another device if needed,
+ * after that device has finished what it keeps the bus for. Inside a slot of the device
+ * the transaction is already open and nothing is done.
+ */
+void UC1609BusDevice::claim() {
+  if (_bus._open == this) return;
+  if (_bus._open && _bus._open->holding()) _bus._open->finish();
+  _bus._close();
+  beginTransaction();
+  _bus._open = this;
+  _bus._transactions++;
+}
+
+/*
+ * End the SPI transaction of the device, unless it is served by UC1609Bus::service(),
+ * which keeps it open for the whole slot.
+ */
+void UC1609BusDevice::release() {
+  if (_bus._slot == this) return;
+  if (_bus._open == this) _bus._close();
+}
+
+uint32_t UC1609BusDevice::bytesPerSecond() const {
+  return _micros ? (uint32_t) ((float) _bytes * 1000000.0f / _micros) : 0;
+}
+
+void UC1609BusDevice::resetStats() {
+  _bytes = 0;
+  _slots = 0;
+  _micros = 0;
+}
+
+/*
+ * Serve a panel on the bus. Drawing queued in the UC1609DrawQueue, if any, goes first,
+ * then the dirty spans of the framebuffer are sent with flushAsync() and service(). The
+ * panel claims the bus through the arbiter from now on, also for direct calls, at the clock
+ * set with UC1609::setSpiClock() before. A panel without a state of flushAsync() gets the
+ * one of the UC1609BusPanel.
+ * param: UC1609 &lcd - the panel
+ *        uint8_t priority - devices with a higher priority are served first
+ *        UC1609DrawQueue *queue - queue of drawing operations of the panel, or nullptr
+ */
+UC1609BusPanel::UC1609BusPanel(UC1609Bus &bus, UC1609 &lcd, uint8_t priority, UC1609DrawQueue *queue):
+  UC1609BusDevice(bus, priority, lcd.spiClock()), _lcd(lcd), _queue(queue) {
+  _lcd.setBusDevice(this);
+  if (!_lcd.asyncState()) _lcd.setAsyncState(&_async);
+}
+
+/*
+ * The panel leaves the bus once its burst is sent, and claims the bus on its own again.
+ */
+UC1609BusPanel::~UC1609BusPanel() {
+  detach();
+  _lcd.setBusDevice(nullptr);
+  if (_lcd.asyncState() == &_async) _lcd.setAsyncState(nullptr);
+}
+
+void UC1609BusPanel::beginTransaction() {
+  if (_lcd.transport())
+    _lcd.transport()->beginTransaction();
+  else
+    UC1609BusDevice::beginTransaction();
+}
+
+void UC1609BusPanel::endTransaction() {
+  if (_lcd.transport())
+    _lcd.transport()->endTransaction();
+  else
+    UC1609BusDevice::endTransaction();
+}
+
+/*
+ * Complete the flushAsync() burst of the back-end that keeps the bus.
+ */
+void UC1609BusPanel::finish() {
+  while (_lcd.isBusClaimed() && _lcd.isBusy()) {
+    _lcd.service();
+    yield();
+  }
+}
+
+bool UC1609BusPanel::pending() {
+  return (_queue && !_queue->isEmpty()) || _lcd.isBusy() || _lcd.isDirty();
+}
+
+uint16_t UC1609BusPanel::transfer(uint16_t maxBytes) {
+  if (_queue && !_queue->isEmpty()) return _queue->service(0xFFFFFFFFUL, maxBytes);
+  if (!_lcd.isBusy()) _lcd.flushAsync();
+  return _lcd.service(maxBytes);
+}
+
+void UC1609Bus::_attach(UC1609BusDevice *device) {
+  UC1609BusDevice **tail = &_devices;
+  while (*tail) tail = &(*tail)->_next;
+  *tail = device;
+}
+
+void UC1609Bus::_detach(UC1609BusDevice *device) {
+  UC1609BusDevice *prev = nullptr;
+  for (UC1609BusDevice **p = &_devices; *p; p = &(*p)->_next) {
+    if (*p == device) {
+      *p = device->_next;
+      break;
+    }
+    prev = *p;
+  }
+  device->_next = nullptr;
+  if (_last == device) _last = prev;   // the turn goes on after the device before it
+}
+
+void UC1609Bus::_close() {
+  if (!_open) return;
+  _open->endTransaction();
+  _open = nullptr;
+}
+
+/*
+ * Internal function returning the pending device with the highest priority, starting
+ * after the device served last so that devices of equal priority take turns.
+ */
+UC1609BusDevice *UC1609Bus::_pick() {
+  if (!_devices) return nullptr;
+  UC1609BusDevice *start = (_last && _last->_next) ? _last->_next : _devices;
+  UC1609BusDevice *device = start;
+  UC1609BusDevice *best = nullptr;
+  do {
+    if ((!best || device->_priority > best->_priority) && device->pending()) best = device;
+    device = device->_next ? device->_next : _devices;
+  } while (device != start);
+  return best;
+}
+
+/*
+ * Hand the bus to the devices with pending work, one slot at a time, to be called from
+ * loop(). The transaction of a device stays open into its next slot when no other device
+ * has work in between, and after the call while the device is holding() the bus.
+ * param: uint16_t slotBytes - bytes a device may send per slot
+ *        uint8_t maxSlots - slots at most, to bound the time of a call
+ * return: bytes sent by all devices
+ */
+uint16_t UC1609Bus::service(uint16_t slotBytes, uint8_t maxSlots) {
+  uint16_t total = 0;
+  UC1609BusDevice *device = (_open && _open->holding()) ? _open : _pick();
+  while (device && maxSlots--) {
+    uint32_t start = micros();
+    device->claim();
+    _slot = device;
+    uint16_t n = device->transfer(slotBytes);
+    _slot = nullptr;
+    device->_bytes += n;
+    device->_slots++;
+    device->_micros += micros() - start;
+    total += n;
+    _last = device;
+    if (device->holding()) return total;   // keeps the transaction, served first next time
+
+    UC1609BusDevice *next = maxSlots ? _pick() : nullptr;
+    if (next != device) _close();
+    device = next;
+  }
+  _close();
+  return total;
+}
@@ -0,0 +1,124 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional arbiter for several UC1609 panels and other devices on one SPI bus.
+ *               Without it, each UC1609 call begins and ends its own SPI transaction. With
+ *               it, the application calls UC1609Bus::service() from loop(), which hands the
+ *               bus to one device with pending work at a time, for a slot of up to slotBytes
+ *               bytes in a single transaction. A device keeps the transaction across
+ *               consecutive slots while it is the only one with work. The device with the
+ *               highest priority goes first, devices of equal priority take turns. A panel
+ *               whose flushAsync() burst is still sent by its UC1609AsyncBackend after its
+ *               slot keeps the bus until the burst is done, the other devices wait.
+ *
+ *               Each device keeps its SPISettings, built once, and counts its bytes, slots and
+ *               time on the bus. A UC1609BusPanel serves a panel from its framebuffer (with
+ *               flushAsync() and service()) or from a UC1609DrawQueue, and begins its
+ *               transactions through its UC1609Transport, if any. Other devices derive
+ *               from UC1609BusDevice, implement pending() and transfer(), and drive their own
+ *               CS pin in transfer().
+ *
+ *               UC1609Bus bus;
+ *               UC1609BusPanel left(bus, lcdLeft);         // framebuffer attached to lcdLeft
+ *               UC1609BusPanel right(bus, lcdRight, 0, &rightQueue);
+ *               void loop() { bus.service(64); }
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_BUS_H
+#define UC1609_BUS_H
+
+#include "UC1609.h"
+#include "UC1609DrawQueue.h"
+
+// bytes of one slot of UC1609Bus::service()
+#ifndef UC1609_BUS_SLOT
+#define UC1609_BUS_SLOT     64
+#endif
+
+class UC1609Bus;
+
+class UC1609BusDevice {
+  public:
+    UC1609BusDevice(UC1609Bus &bus, uint8_t priority = 0, uint32_t clock = SPI_CLOCK,
+                    uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0);
+    virtual ~UC1609BusDevice();
+
+    // true while the device has something to send
+    virtual bool pending() = 0;
+    // send up to maxBytes with the bus claimed, return the bytes sent
+    virtual uint16_t transfer(uint16_t maxBytes) = 0;
+
+    // SPI transaction of the device, outside of a slot around each access to the device
+    void claim();
+    void release();
+    // take the device off the bus, it is no longer served by UC1609Bus::service()
+    void detach();
+
+    uint8_t priority() const { return _priority; }
+    uint32_t bytes() const { return _bytes; }
+    uint32_t slots() const { return _slots; }
+    uint32_t busMicros() const { return _micros; }
+    uint32_t bytesPerSecond() const;
+    void resetStats();
+
+  protected:
+    // SPI transaction of the device, on the global SPI object by default
+    virtual void beginTransaction() { SPI.beginTransaction(_settings); }
+    virtual void endTransaction() { SPI.endTransaction(); }
+    // true while the device must keep the bus between slots, e.g. a DMA transfer in flight
+    virtual bool holding() { return false; }
+    // complete what holding() waits for, before another device takes the bus
+    virtual void finish() {}
+
+  private:
+    friend class UC1609Bus;
+    UC1609Bus &_bus;
+    SPISettings _settings;
+    uint8_t _priority;
+    UC1609BusDevice *_next{nullptr};
+    uint32_t _bytes{0};
+    uint32_t _slots{0};
+    uint32_t _micros{0};
+};
+
+class UC1609BusPanel: public UC1609BusDevice {
+  public:
+    UC1609BusPanel(UC1609Bus &bus, UC1609 &lcd, uint8_t priority = 0, UC1609DrawQueue *queue = nullptr);
+    ~UC1609BusPanel();
+
+    bool pending() override;
+    uint16_t transfer(uint16_t maxBytes) override;
+
+  protected:
+    void beginTransaction() override;
+    void endTransaction() override;
+    bool holding() override { return _lcd.isBusClaimed(); }
+    void finish() override;
+
+  private:
+    UC1609 &_lcd;
+    UC1609DrawQueue *_queue;
+    UC1609AsyncState _async;    // of the panel, unless it has one already
+};
+
+class UC1609Bus {
+  public:
+    uint16_t service(uint16_t slotBytes = UC1609_BUS_SLOT, uint8_t maxSlots = 255);
+    uint32_t transactions() const { return _transactions; }
+
+  private:
+    friend class UC1609BusDevice;
+    UC1609BusDevice *_devices{nullptr};
+    UC1609BusDevice *_open{nullptr};    // device whose SPI transaction is open
+    UC1609BusDevice *_slot{nullptr};    // device served by service()
+    UC1609BusDevice *_last{nullptr};    // device served last, for the turns
+    uint32_t _transactions{0};
+
+    void _attach(UC1609BusDevice *device);
+    void _detach(UC1609BusDevice *device);
+    void _close();
+    UC1609BusDevice *_pick();
+};
+
+#endif
@@ -0,0 +1,321 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional lock-free channel for sharing one display between RTOS tasks, see UC1609Channel.h.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include <string.h>
+#include "UC1609Channel.h"
+
+#if defined(__AVR__)
+#include <util/atomic.h>
+
+static inline uint32_t loadAcquire(const volatile uint32_t *p) {
+  uint32_t v;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { v = *p; }
+  return v;
+}
+
+static inline void storeRelease(volatile uint32_t *p, uint32_t v) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *p = v; }
+}
+
+static inline bool compareAndSwap(volatile uint32_t *p, uint32_t expected, uint32_t desired) {
+  bool swapped = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (*p == expected) {
+      *p = desired;
+      swapped = true;
+    }
+  }
+  return swapped;
+}
+
+static inline void increment(volatile uint32_t *p) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { (*p)++; }
+}
+#elif __GCC_ATOMIC_INT_LOCK_FREE < 2
+// No 32-bit compare-and-swap instruction, e.g. armv6-m (Cortex-M0/M0+ of the SAMD21 or
+// RP2040), where the __atomic builtins become library calls: short critical sections as
+// on AVR. They only exclude the ISRs of the same core, on an RP2040 post from one core.
+#if defined(__arm__)
+static inline uint32_t disableInterrupts() {
+  uint32_t primask;
+  __asm__ volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+  return primask;
+}
+
+static inline void restoreInterrupts(uint32_t primask) {
+  __asm__ volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+#else
+static inline uint32_t disableInterrupts() {
+  noInterrupts();
+  return 0;
+}
+
+static inline void restoreInterrupts(uint32_t state) {
+  (void) state;
+  interrupts();
+}
+#endif
+
+static inline uint32_t loadAcquire(const volatile uint32_t *p) {
+  uint32_t state = disableInterrupts();
+  uint32_t v = *p;
+  restoreInterrupts(state);
+  return v;
+}
+
+static inline void storeRelease(volatile uint32_t *p, uint32_t v) {
+  uint32_t state = disableInterrupts();
+  *p = v;
+  restoreInterrupts(state);
+}
+
+static inline bool compareAndSwap(volatile uint32_t *p, uint32_t expected, uint32_t desired) {
+  uint32_t state = disableInterrupts();
+  bool swapped = *p == expected;
+  if (swapped) *p = desired;
+  restoreInterrupts(state);
+  return swapped;
+}
+
+static inline void increment(volatile uint32_t *p) {
+  uint32_t state = disableInterrupts();
+  (*p)++;
+  restoreInterrupts(state);
+}
+#else
+static inline uint32_t loadAcquire(const volatile uint32_t *p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(volatile uint32_t *p, uint32_t v) {
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline bool compareAndSwap(volatile uint32_t *p, uint32_t expected, uint32_t desired) {
+  return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static inline void increment(volatile uint32_t *p) {
+  __atomic_fetch_add(p, 1, __ATOMIC_RELAXED);
+}
+#endif
+
+/*
+ * Create a channel on an array of slots provided by the application.
+ * param: UC1609ChannelSlot *slots - slots of the ring
+ *        uint8_t size - number of slots, a power of 2 (a larger size is rounded down), at
+ *                       least 2. With fewer slots or no slots the channel has no capacity
+ *                       and every post() fails.
+ *        uint8_t policy - CHANNEL_DROP, CHANNEL_OVERWRITE or CHANNEL_BLOCK, when the ring is full
+ *        bool multiProducer - false if only one task or ISR ever posts
+ */
+UC1609Channel::UC1609Channel(UC1609ChannelSlot *slots, uint8_t size, uint8_t policy, bool multiProducer):
+  _slots(slots), _mask(0), _policy(policy), _multiProducer(multiProducer) {
+  if (!slots || size < 2) {
+    _slots = nullptr;         // a single slot would be published and claimed again at once
+    return;
+  }
+  uint8_t n = 2;
+  while ((uint8_t) (n << 1) && (uint8_t) (n << 1) <= size) n <<= 1;
+  _mask = n - 1;
+  for (uint8_t i = 0; i < n; i++) _slots[i].seq = i;
+}
+
+/*
+ * Internal function claiming the slot at the write position, copying the message in and
+ * publishing it to the owner.
+ * return: false if the ring is full
+ */
+bool UC1609Channel::_tryPost(const UC1609Message &msg) {
+  uint32_t pos = loadAcquire(&_writePos);
+  UC1609ChannelSlot *slot;
+  for (;;) {
+    slot = &_slots[pos & _mask];
+    int32_t diff = (int32_t) (loadAcquire(&slot->seq) - pos);
+    if (diff == 0) {
+      if (!_multiProducer) {
+        storeRelease(&_writePos, pos + 1);
+        break;
+      }
+      if (compareAndSwap(&_writePos, pos, pos + 1)) break;
+      pos = loadAcquire(&_writePos);
+    }
+    else if (diff < 0) {
+      return false;               // the owner has not taken the message of this slot yet
+    }
+    else {
+      pos = loadAcquire(&_writePos);   // another producer took the slot
+    }
+  }
+  slot->msg = msg;
+  storeRelease(&slot->seq, pos + 1);
+  return true;
+}
+
+/*
+ * Post a request to the owner of the display, following the policy of the channel when
+ * the ring is full.
+ * return: false if the request was dropped
+ */
+bool UC1609Channel::post(const UC1609Message &msg) {
+  if (!_slots) {
+    increment(&_dropped);
+    return false;
+  }
+  while (!_tryPost(msg)) {
+    if (_policy == CHANNEL_OVERWRITE) {
+      // the oldest slot can be claimed by an owner that this ISR or task interrupted, it
+      // is only published again once the owner runs, so drop the request instead of waiting
+      UC1609Message oldest;
+      if (!receive(oldest)) {
+        increment(&_dropped);
+        return false;
+      }
+      increment(&_overwritten);
+    }
+    else if (_policy == CHANNEL_BLOCK) {
+      yield();
+    }
+    else {
+      increment(&_dropped);
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Post text printed at a column and line in the current font of the owner, longer text
+ * than UC1609_MESSAGE_TEXT characters is cut.
+ */
+bool UC1609Channel::postText(uint8_t col, uint8_t line, const char *str) {
+  UC1609Message msg;
+  size_t len = strlen(str);
+  msg.type = MESSAGE_TEXT;
+  msg.x = col;
+  msg.line = line;
+  msg.w = (len > UC1609_MESSAGE_TEXT) ? UC1609_MESSAGE_TEXT : len;
+  memcpy(msg.text, str, msg.w);
+  return post(msg);
+}
+
+/*
+ * Post a fill of whole lines, see UC1609::fillRect().
+ */
+bool UC1609Channel::postFill(uint8_t x, uint8_t line, uint8_t w, uint8_t pages, uint8_t pattern) {
+  UC1609Message msg;
+  msg.type = MESSAGE_FILL;
+  msg.x = x;
+  msg.line = line;
+  msg.w = w;
+  msg.h = pages;
+  msg.value = pattern;
+  return post(msg);
+}
+
+/*
+ * Post an image, see UC1609::drawImage(). The image data is not copied and must stay
+ * valid until it is drawn, which is the case for IMAGE() arrays in flash.
+ */
+bool UC1609Channel::postImage(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *data) {
+  UC1609Message msg;
+  msg.type = MESSAGE_IMAGE;
+  msg.x = x;
+  msg.line = y;
+  msg.w = w;
+  msg.h = h;
+  msg.data = data;
+  return post(msg);
+}
+
+/*
+ * Post MESSAGE_CONTRAST, MESSAGE_INVERT with its value, or MESSAGE_FLUSH to send the
+ * framebuffer of the owner.
+ */
+bool UC1609Channel::postCommand(uint8_t type, uint8_t value) {
+  UC1609Message msg;
+  msg.type = type;
+  msg.value = value;
+  return post(msg);
+}
+
+/*
+ * Take the oldest request out of the channel, called by the owner. Also safe from
+ * several tasks, which the CHANNEL_OVERWRITE policy relies on.
+ * return: false if the channel is empty
+ */
+bool UC1609Channel::receive(UC1609Message &msg) {
+  if (!_slots) return false;
+  uint32_t pos = loadAcquire(&_readPos);
+  UC1609ChannelSlot *slot;
+  for (;;) {
+    slot = &_slots[pos & _mask];
+    int32_t diff = (int32_t) (loadAcquire(&slot->seq) - (pos + 1));
+    if (diff == 0) {
+      if (compareAndSwap(&_readPos, pos, pos + 1)) break;
+      pos = loadAcquire(&_readPos);
+    }
+    else if (diff < 0) {
+      return false;               // no producer has published this slot yet
+    }
+    else {
+      pos = loadAcquire(&_readPos);
+    }
+  }
+  msg = slot->msg;
+  storeRelease(&slot->seq, pos + _mask + 1);
+  return true;
+}
+
+/*
+ * Draw the posted requests in order, called by the owner task only. All requests drawn
+ * in one call share one SPI transaction.
+ * param: uint8_t maxMessages - the most requests drawn, to bound the time of a call
+ * return: number of requests drawn
+ */
+uint8_t UC1609Channel::dispatch(UC1609 &lcd, uint8_t maxMessages) {
+  UC1609Message msg;
+  uint8_t n = 0;
+  if (!maxMessages || !receive(msg)) return 0;
+
+  lcd.beginBatch();
+  do {
+    switch (msg.type) {
+      case MESSAGE_TEXT:
+        lcd.setCursor(msg.x, msg.line);
+        lcd.write((const uint8_t *) msg.text, msg.w);
+        break;
+      case MESSAGE_FILL:
+        lcd.fillRect(msg.x, msg.line, msg.w, msg.h, msg.value);
+        break;
+      case MESSAGE_IMAGE:
+        lcd.drawImage(msg.x, msg.line, msg.w, msg.h, msg.data);
+        break;
+      case MESSAGE_CONTRAST:
+        lcd.setContrast(msg.value);
+        break;
+      case MESSAGE_INVERT:
+        lcd.invert(msg.value);
+        break;
+      case MESSAGE_FLUSH:
+        lcd.flush();
+        break;
+    }
+    n++;
+  } while (n < maxMessages && receive(msg));
+  lcd.endBatch();
+  return n;
+}
+
+uint32_t UC1609Channel::dropped() const {
+  return loadAcquire(&_dropped);
+}
+
+uint32_t UC1609Channel::overwritten() const {
+  return loadAcquire(&_overwritten);
+}
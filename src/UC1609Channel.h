@@ -0,0 +1,105 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional lock-free channel for sharing one display between RTOS tasks. The
+ *               UC1609 object is not thread-safe: write() updates the cursor and sends several
+ *               SPI sequences, so two tasks printing at the same time corrupt each other's
+ *               output. Instead, a single owner task holds the UC1609 object and calls
+ *               dispatch(), other tasks and ISRs post() draw requests into a bounded ring
+ *               buffer. Each request is drawn whole, from its own cursor position.
+ *
+ *               The ring is the bounded queue of D. Vyukov: each slot has a sequence number, a
+ *               producer claims a slot with one compare-and-swap on the write position and a
+ *               consumer on the read position, no task ever waits for a lock. With a single
+ *               producer (one task, or one ISR) the compare-and-swap on the write position is
+ *               left out. When the ring is full, post() follows the policy of the channel:
+ *                 CHANNEL_DROP       the request is dropped, post() returns false
+ *                 CHANNEL_OVERWRITE  the oldest request is dropped to make room, or the new
+ *                                    one while the owner is still taking the oldest
+ *                 CHANNEL_BLOCK      post() waits with yield() for the owner, never from an ISR
+ *
+ *               UC1609ChannelSlot slots[16];           // power of 2, at least 2, 16 x 28 bytes on ESP32
+ *               UC1609Channel channel(slots, 16, CHANNEL_BLOCK, true);
+ *               channel.postText(0, 3, "wifi: connected");  // any task
+ *               void displayTask(void *) { for (;;) { channel.dispatch(lcd); vTaskDelay(10); } }
+ *
+ *               On AVR, which has no atomic instructions, and on cores without a 32-bit
+ *               compare-and-swap (armv6-m: Cortex-M0/M0+), the channel uses short critical
+ *               sections with interrupts disabled.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_CHANNEL_H
+#define UC1609_CHANNEL_H
+
+#include "UC1609.h"
+
+// characters of text held by one request
+#ifndef UC1609_MESSAGE_TEXT
+#define UC1609_MESSAGE_TEXT 16
+#endif
+
+// policies of a full channel
+#define CHANNEL_DROP        0
+#define CHANNEL_OVERWRITE   1
+#define CHANNEL_BLOCK       2
+
+// types of UC1609Message
+#define MESSAGE_TEXT        0
+#define MESSAGE_FILL        1
+#define MESSAGE_IMAGE       2
+#define MESSAGE_CONTRAST    3
+#define MESSAGE_INVERT      4
+#define MESSAGE_FLUSH       5
+
+struct UC1609Message {
+  uint8_t type;
+  uint8_t x;          // column
+  uint8_t line;       // line, or y of an image
+  uint8_t w;          // width in columns, or text length
+  uint8_t h;          // height in lines, or in pixels for an image
+  uint8_t value;      // fill pattern, or command value
+  union {
+    const uint8_t *data;
+    char text[UC1609_MESSAGE_TEXT];
+  };
+};
+
+struct UC1609ChannelSlot {
+  volatile uint32_t seq;
+  UC1609Message msg;
+};
+
+class UC1609Channel {
+  public:
+    UC1609Channel(UC1609ChannelSlot *slots, uint8_t size, uint8_t policy = CHANNEL_DROP, bool multiProducer = true);
+
+    // producers, any task, or an ISR unless the policy is CHANNEL_BLOCK
+    bool post(const UC1609Message &msg);
+    bool postText(uint8_t col, uint8_t line, const char *str);
+    bool postFill(uint8_t x, uint8_t line, uint8_t w, uint8_t pages, uint8_t pattern);
+    bool postImage(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *data);
+    bool postCommand(uint8_t type, uint8_t value = 0);
+
+    // owner
+    bool receive(UC1609Message &msg);
+    uint8_t dispatch(UC1609 &lcd, uint8_t maxMessages = 255);
+
+    uint8_t capacity() const { return _slots ? _mask + 1 : 0; }
+    uint32_t dropped() const;
+    uint32_t overwritten() const;
+
+  private:
+    UC1609ChannelSlot *_slots;
+    uint32_t _mask;
+    uint8_t _policy;
+    bool _multiProducer;
+    volatile uint32_t _writePos{0};
+    volatile uint32_t _readPos{0};
+    volatile uint32_t _dropped{0};
+    volatile uint32_t _overwritten{0};
+
+    bool _tryPost(const UC1609Message &msg);
+};
+
+#endif
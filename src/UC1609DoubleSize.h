@@ -0,0 +1,115 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Compile-time generator of pre-stretched (and optionally pre-anti-aliased)
+ *               double-size font tables. The tables are built by the compiler from any
+ *               5x7 font in fonts.h and are placed in flash, write() streams them as-is
+ *               at font scale 2 instead of stretching every glyph at runtime.
+ *
+ *               lcd.setFont(font5x7_numeric);
+ *               lcd.setDoubleSizeFont(UC1609_DOUBLE_SIZE(font5x7_numeric));
+ *               lcd.setFontScale(2);
+ *
+ *               A table takes 24 bytes of flash per glyph (12 columns x 2 pages), e.g.
+ *               648 bytes for font5x7_numeric and 6144 bytes for font5x7_extended, and
+ *               only the tables that are referenced are compiled into the program.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_DOUBLE_SIZE_H
+#define UC1609_DOUBLE_SIZE_H
+
+#include <stdint.h>
+#include "UC1609Flash.h"
+
+/*
+ * Table layout, same header as the source font followed by the glyphs:
+ *   [0] width, [1] height, [2] first char, [3] last char of the source font
+ *   [4 + glyph * 24 + 0..11]  top page columns, [4 + glyph * 24 + 12..23] bottom page columns
+ * Column 0 and 11 of each glyph are the padding columns.
+ */
+#define UC1609_DOUBLE_SIZE(font)       (UC1609DoubleSize<font, true>::table)
+#define UC1609_DOUBLE_SIZE_NOAA(font)  (UC1609DoubleSize<font, false>::table)
+
+#define UC1609_DOUBLE_GLYPH_SIZE 24
+
+// Hacker's Delight bit stretching (see UC1609::_stretch()), one expression per step for C++11
+constexpr uint16_t _uc1609Pair(uint16_t d) { return d | d << 1; }                 // aabbccdd eeffgghh
+constexpr uint16_t _uc1609Spread1(uint16_t d) { return (d << 1 | d) & 0x5555; }   // 0a0b0c0d 0e0f0g0h
+constexpr uint16_t _uc1609Spread2(uint16_t d) { return (d << 2 | d) & 0x3333; }   // 00ab00cd 00ef00gh
+constexpr uint16_t _uc1609Stretch(uint8_t x) {
+  return _uc1609Pair(_uc1609Spread1(_uc1609Spread2((x & 0xF0) << 4 | (x & 0x0F))));
+}
+
+// 16-bit stretched column k (0-11) of a glyph, columns 0 and 11 are padding
+constexpr uint16_t _uc1609Column(const uint8_t *font, uint16_t glyph, uint8_t k) {
+  return (k == 0 || k > 2 * font[0]) ? 0 : _uc1609Stretch(font[4 + glyph * font[0] + (k - 1) / 2]);
+}
+
+/*
+ * Anti-aliasing of a column pair, the same staircase detection as UC1609::_antiAliasing():
+ * the left column has the 2-bit pattern 0b1100 at bit pair i while the right column has
+ * 0b0011 (or the reverse), expressed with masks on all bit pairs at once.
+ *   zeros: bit 2i set when bits 2i and 2i+1 are both clear
+ *   ones:  bit 2i set when bits 2i and 2i+1 are both set
+ */
+constexpr uint16_t _uc1609Zeros(uint16_t v) { return (uint16_t) (~v & (~v >> 1) & 0x5555); }
+constexpr uint16_t _uc1609Ones(uint16_t v) { return (uint16_t) (v & (v >> 1) & 0x5555); }
+constexpr uint16_t _uc1609Rising(uint16_t v) { return _uc1609Zeros(v) & (_uc1609Ones(v) >> 2) & 0x0555; }   // 0b1100
+constexpr uint16_t _uc1609Falling(uint16_t v) { return _uc1609Ones(v) & (_uc1609Zeros(v) >> 2) & 0x0555; } // 0b0011
+constexpr uint16_t _uc1609AddedLeft(uint16_t l, uint16_t r) {
+  return (uint16_t) ((_uc1609Rising(l) & _uc1609Falling(r)) << 1 | (_uc1609Falling(l) & _uc1609Rising(r)) << 2);
+}
+constexpr uint16_t _uc1609AddedRight(uint16_t l, uint16_t r) {
+  return (uint16_t) ((_uc1609Rising(l) & _uc1609Falling(r)) << 2 | (_uc1609Falling(l) & _uc1609Rising(r)) << 1);
+}
+
+// the column pairs at the boundary of two stretched source columns are (2,3), (4,5), (6,7), (8,9)
+constexpr uint16_t _uc1609Smoothed(const uint8_t *font, uint16_t glyph, uint8_t k) {
+  return _uc1609Column(font, glyph, k) |
+    ((k >= 2 && k <= 8 && (k & 1) == 0) ? _uc1609AddedLeft(_uc1609Column(font, glyph, k), _uc1609Column(font, glyph, k + 1)) : 0) |
+    ((k >= 3 && k <= 9 && (k & 1) == 1) ? _uc1609AddedRight(_uc1609Column(font, glyph, k - 1), _uc1609Column(font, glyph, k)) : 0);
+}
+
+constexpr uint16_t _uc1609DoubleColumn(const uint8_t *font, bool aa, uint16_t glyph, uint8_t k) {
+  return aa ? _uc1609Smoothed(font, glyph, k) : _uc1609Column(font, glyph, k);
+}
+
+// byte i of the table
+constexpr uint8_t _uc1609DoubleSizeByte(const uint8_t *font, bool aa, uint16_t i) {
+  return i < 4 ? font[i] :
+    (uint8_t) (_uc1609DoubleColumn(font, aa, (i - 4) / UC1609_DOUBLE_GLYPH_SIZE, (i - 4) % 12) >> (((i - 4) % UC1609_DOUBLE_GLYPH_SIZE) < 12 ? 0 : 8));
+}
+
+// index sequence with logarithmic template depth (a table has up to 6148 bytes)
+template <uint16_t... I> struct UC1609Indices {};
+
+template <class A, class B> struct UC1609JoinIndices;
+template <uint16_t... A, uint16_t... B>
+struct UC1609JoinIndices<UC1609Indices<A...>, UC1609Indices<B...> > {
+  typedef UC1609Indices<A..., (uint16_t) (sizeof...(A) + B)...> type;
+};
+
+template <uint16_t N> struct UC1609MakeIndices {
+  typedef typename UC1609JoinIndices<typename UC1609MakeIndices<N / 2>::type,
+                                     typename UC1609MakeIndices<N - N / 2>::type>::type type;
+};
+template <> struct UC1609MakeIndices<0> { typedef UC1609Indices<> type; };
+template <> struct UC1609MakeIndices<1> { typedef UC1609Indices<0> type; };
+
+template <const uint8_t *Font, bool AntiAliasing,
+          class Indices = typename UC1609MakeIndices<4 + (Font[3] - Font[2] + 1) * UC1609_DOUBLE_GLYPH_SIZE>::type>
+struct UC1609DoubleSize;
+
+template <const uint8_t *Font, bool AntiAliasing, uint16_t... I>
+struct UC1609DoubleSize<Font, AntiAliasing, UC1609Indices<I...> > {
+  static_assert(Font[0] == 5, "UC1609DoubleSize only supports 5-column fonts");
+  static const uint8_t table[sizeof...(I)];
+};
+
+template <const uint8_t *Font, bool AntiAliasing, uint16_t... I>
+const uint8_t UC1609DoubleSize<Font, AntiAliasing, UC1609Indices<I...> >::table[sizeof...(I)] FlashAttr = {
+  _uc1609DoubleSizeByte(Font, AntiAliasing, I)...
+};
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional time-budgeted queue of drawing operations for the UC1609 library, see UC1609DrawQueue.h.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include <string.h>
+#include "UC1609DrawQueue.h"
+
+#define OP_TEXT     0
+#define OP_FILL     1
+#define OP_IMAGE    2
+#define OP_COMMAND  3
+
+// command bytes of the column and page address sent ahead of the data of each line
+#define ADDRESS_BYTES 3
+
+/*
+ * Internal function returning a free entry at the tail of the ring, nullptr when full.
+ */
+UC1609DrawOp *UC1609DrawQueue::_push() {
+  if (_count == _size) return nullptr;
+  uint8_t tail = _head + _count;
+  if (tail >= _size) tail -= _size;
+  _count++;
+  if (_count > _highWater) _highWater = _count;
+  UC1609DrawOp *op = &_ops[tail];
+  op->page = 0;
+  op->col = 0;
+  return op;
+}
+
+/*
+ * Queue text printed at a column and line, in the current font of the display at the
+ * time it is drawn. Text longer than UC1609_QUEUE_TEXT characters takes several entries,
+ * it is only queued if they are all free.
+ * return: false if the queue is full
+ */
+bool UC1609DrawQueue::text(uint8_t col, uint8_t line, const char *str) {
+  size_t len = strlen(str);
+  uint8_t entries = (len + UC1609_QUEUE_TEXT - 1) / UC1609_QUEUE_TEXT;
+  if (len > (size_t) UC1609_QUEUE_TEXT * 255 || entries > _size - _count) return false;
+
+  for (uint8_t i = 0; i < entries; i++) {
+    UC1609DrawOp *op = _push();
+    uint8_t n = (len > UC1609_QUEUE_TEXT) ? UC1609_QUEUE_TEXT : len;
+    op->type = OP_TEXT;
+    op->x = (i == 0) ? col : UC1609_UNKNOWN;   // continuation: where the previous entry ended
+    op->line = line;
+    op->w = n;
+    memcpy(op->text, str, n);
+    str += n;
+    len -= n;
+  }
+  return true;
+}
+
+/*
+ * Queue a fill of whole lines, see UC1609::fillRect().
+ * return: false if the queue is full
+ */
+bool UC1609DrawQueue::fill(uint8_t x, uint8_t line, uint8_t w, uint8_t pages, uint8_t pattern) {
+  UC1609DrawOp *op = _push();
+  if (!op) return false;
+  op->type = OP_FILL;
+  op->x = x;
+  op->line = line;
+  op->w = w;
+  op->pages = pages;
+  op->value = pattern;
+  return true;
+}
+
+/*
+ * Queue an image, see UC1609::drawImage(). The image data is not copied and must stay
+ * valid until it is drawn, which is the case for IMAGE() arrays in flash.
+ * return: false if the queue is full
+ */
+bool UC1609DrawQueue::image(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *data) {
+  UC1609DrawOp *op = _push();
+  if (!op) return false;
+  op->type = OP_IMAGE;
+  op->x = x;
+  op->line = y >> 3;
+  op->w = w;
+  op->pages = (h + 7) >> 3;
+  op->data = data;
+  return true;
+}
+
+/*
+ * Queue a display setting, so that it takes effect in order with the drawing.
+ * param: uint8_t command - QUEUE_CONTRAST, QUEUE_INVERT, QUEUE_ROTATE, QUEUE_SCROLL or QUEUE_ENABLE
+ *        uint8_t value - argument of setContrast(), invert(), rotate(), scroll() or enableDisplay()
+ * return: false if the queue is full
+ */
+bool UC1609DrawQueue::command(uint8_t command, uint8_t value) {
+  UC1609DrawOp *op = _push();
+  if (!op) return false;
+  op->type = OP_COMMAND;
+  op->x = command;
+  op->value = value;
+  return true;
+}
+
+/*
+ * Draw queued operations until the time or the byte budget is used up. The cost of the
+ * next step (a few characters at the font scale, a part of a line of a fill, whole lines
+ * of an image) is estimated from its data and address bytes at the SPI clock of the
+ * display, and a step that does not fit in what is left of the budget is left for the
+ * next call. A line change of text that clears the screen is costed as the whole screen.
+ * The first step of a call is always drawn, so that the queue makes progress even with a
+ * budget smaller than a step. Everything drawn in one call shares one SPI transaction.
+ * param: uint32_t maxMicros - time budget in us
+ *        uint16_t maxBytes - byte budget
+ * return: estimated number of bytes drawn
+ */
+uint16_t UC1609DrawQueue::service(uint32_t maxMicros, uint16_t maxBytes) {
+  uint32_t start = micros();
+  uint16_t sent = 0;
+  if (!_count) return 0;
+
+  _lcd.beginBatch();
+  while (_count && sent < maxBytes) {
+    uint32_t elapsed = micros() - start;
+    if (elapsed >= maxMicros && sent) break;
+    uint32_t left = (elapsed < maxMicros) ? maxMicros - elapsed : 0;
+    uint32_t fit = (uint64_t) left * _lcd.spiClock() / 8000000UL;
+    if (fit > 0xFFFF) fit = 0xFFFF;
+    uint16_t budget = maxBytes - sent;
+    if (fit < budget) budget = fit;
+    if (budget == 0 && sent) break;
+
+    uint16_t n = _step(_ops[_head], budget, sent == 0);
+    if (n == 0) break;
+    sent += n;
+  }
+  _lcd.endBatch();
+  return sent;
+}
+
+/*
+ * Internal function drawing the next part of an operation that costs at most maxBytes,
+ * or its smallest part if force is set, and removing the operation from the queue once
+ * it is complete.
+ * return: estimated number of bytes drawn, 0 if no part of it fits in maxBytes
+ */
+uint16_t UC1609DrawQueue::_step(UC1609DrawOp &op, uint16_t maxBytes, bool force) {
+  uint16_t bytes = 0;
+  bool done = false;
+
+  switch (op.type) {
+    case OP_TEXT: {
+      // characters are costed one by one at the cursor, see UC1609::writeCost(), so a
+      // line change that clears the screen is only drawn when its cost fits the budget,
+      // or as the first step of a call
+      uint8_t n = 0;
+      if (op.x == UC1609_UNKNOWN) {
+        op.x = _textCol;
+        op.line = _textLine;
+      }
+      _lcd.setCursor(op.x, op.line);
+      bytes = ADDRESS_BYTES;
+      while (op.col < op.w) {
+        uint16_t cost = _lcd.writeCost(op.text[op.col]);
+        if (bytes + cost > maxBytes && !(force && n == 0)) break;
+        _lcd.write((uint8_t) op.text[op.col++]);
+        bytes += cost;
+        n++;
+      }
+      if (n == 0) return 0;
+      op.x = _textCol = _lcd.cursorCol();
+      op.line = _textLine = _lcd.cursorLine();
+      done = op.col == op.w;
+      break;
+    }
+    case OP_FILL: {
+      uint16_t rest = (uint16_t) (op.pages - op.page) * (op.w + ADDRESS_BYTES);
+      if (op.col == 0 && rest <= maxBytes) {
+        _lcd.fillRect(op.x, op.line + op.page, op.w, op.pages - op.page, op.value);
+        bytes = rest;
+        done = true;
+        break;
+      }
+      uint8_t n = op.w - op.col;
+      uint16_t room = (maxBytes > ADDRESS_BYTES) ? maxBytes - ADDRESS_BYTES : 0;
+      if (n > room) n = room;
+      if (n == 0 && force) n = 1;
+      if (n == 0) return 0;
+      _lcd.fillRect(op.x + op.col, op.line + op.page, n, 1, op.value);
+      bytes = n + ADDRESS_BYTES;
+      op.col += n;
+      if (op.col == op.w) {
+        op.col = 0;
+        done = ++op.page == op.pages;
+      }
+      break;
+    }
+    case OP_IMAGE: {
+      uint8_t n = op.pages - op.page;
+      uint16_t line = op.w + ADDRESS_BYTES;
+      if (n > maxBytes / line) n = maxBytes / line;
+      if (n == 0 && force) n = 1;
+      if (n == 0) return 0;
+      _lcd.drawImage(op.x, (op.line + op.page) * 8, op.w, n * 8, op.data + op.page * op.w);
+      bytes = n * line;
+      op.page += n;
+      done = op.page == op.pages;
+      break;
+    }
+    default:
+      switch (op.x) {
+        case QUEUE_CONTRAST: _lcd.setContrast(op.value); break;
+        case QUEUE_INVERT:   _lcd.invert(op.value); break;
+        case QUEUE_ROTATE:   _lcd.rotate(op.value); break;
+        case QUEUE_SCROLL:   _lcd.scroll(op.value); break;
+        case QUEUE_ENABLE:   _lcd.enableDisplay(op.value); break;
+      }
+      bytes = 2;
+      done = true;
+  }
+
+  if (done) {
+    if (++_head == _size) _head = 0;
+    _count--;
+  }
+  return bytes ? bytes : 1;
+}
@@ -0,0 +1,82 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional time-budgeted queue of drawing operations for the UC1609 library.
+ *               Text, fills, images and commands are queued instead of drawn, and service()
+ *               draws them from loop() until a time or byte budget is used up, resuming a
+ *               partly drawn operation at the next character, page or column. A long print()
+ *               or a clearDisplay() is thereby spread over several ticks of a loop() with
+ *               hard timing. depth() and highWater() help to size the queue.
+ *
+ *               UC1609DrawOp ops[16];                 // 16 x 16 bytes on AVR
+ *               UC1609DrawQueue queue(lcd, ops, 16);
+ *               queue.text(0, 2, "Temp: 24.8c");
+ *               void loop() { queue.service(200); }  // at most about 200us per tick
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_DRAW_QUEUE_H
+#define UC1609_DRAW_QUEUE_H
+
+#include "UC1609.h"
+
+// characters of text held by one queue entry, longer text takes several entries
+#ifndef UC1609_QUEUE_TEXT
+#define UC1609_QUEUE_TEXT   8
+#endif
+
+// commands of UC1609DrawQueue::command()
+#define QUEUE_CONTRAST      0
+#define QUEUE_INVERT        1
+#define QUEUE_ROTATE        2
+#define QUEUE_SCROLL        3
+#define QUEUE_ENABLE        4
+
+struct UC1609DrawOp {
+  uint8_t type;
+  uint8_t x;          // column, or command
+  uint8_t line;       // first line
+  uint8_t w;          // width in columns, or text length
+  uint8_t pages;      // height in lines
+  uint8_t value;      // fill pattern, or command value
+  uint8_t page;       // progress: line, column or character to draw next
+  uint8_t col;
+  union {
+    const uint8_t *data;
+    char text[UC1609_QUEUE_TEXT];
+  };
+};
+
+class UC1609DrawQueue {
+  public:
+    UC1609DrawQueue(UC1609 &lcd, UC1609DrawOp *ops, uint8_t size): _lcd(lcd), _ops(ops), _size(size) {}
+
+    bool text(uint8_t col, uint8_t line, const char *str);
+    bool fill(uint8_t x, uint8_t line, uint8_t w, uint8_t pages, uint8_t pattern);
+    bool clear() { return fill(0, 0, UC1609_COLUMNS, UC1609_PAGES, 0x00); }
+    bool image(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *data);
+    bool command(uint8_t command, uint8_t value);
+
+    uint16_t service(uint32_t maxMicros, uint16_t maxBytes = 0xFFFF);
+
+    uint8_t depth() const { return _count; }
+    uint8_t capacity() const { return _size; }
+    uint8_t highWater() const { return _highWater; }
+    void resetHighWater() { _highWater = _count; }
+    bool isEmpty() const { return _count == 0; }
+
+  private:
+    UC1609 &_lcd;
+    UC1609DrawOp *_ops;
+    uint8_t _size;
+    uint8_t _head{0};       // oldest entry, drawn next
+    uint8_t _count{0};
+    uint8_t _highWater{0};
+    uint8_t _textCol{0};    // where the last text entry ended, for the continuation of long text
+    uint8_t _textLine{0};
+
+    UC1609DrawOp *_push();
+    uint16_t _step(UC1609DrawOp &op, uint16_t maxBytes, bool force);
+};
+
+#endif
@@ -0,0 +1,30 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Flash placement and access of the fonts, images and pre-stretched tables
+ *               of the UC1609 library: PROGMEM and pgm_read_*() on AVR, plain constant
+ *               data everywhere else.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_FLASH_H
+#define UC1609_FLASH_H
+
+#include <stdint.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#define FlashAttr PROGMEM
+#define FlashMem(n) constexpr uint8_t PROGMEM n[]
+#define IMAGE(imgN) const uint8_t PROGMEM imgN[]
+#define readFontByte(addr) pgm_read_byte(&addr)
+#define readFontDword(addr) pgm_read_dword(&addr)
+#else
+#define FlashAttr
+#define FlashMem(n) constexpr uint8_t n[]
+#define IMAGE(imgN) const uint8_t imgN[]
+#define readFontByte(addr) (addr)
+#define readFontDword(addr) (addr)
+#endif
+
+#endif
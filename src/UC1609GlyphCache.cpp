@@ -0,0 +1,85 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional RAM cache of scaled glyphs for the UC1609 library, see UC1609GlyphCache.h.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include "UC1609GlyphCache.h"
+
+/*
+ * Create a cache on top of a user-provided array of entries.
+ * param: UC1609GlyphCacheEntry *entries - storage for the cache
+ *        uint8_t size - number of entries
+ */
+UC1609GlyphCache::UC1609GlyphCache(UC1609GlyphCacheEntry *entries, uint8_t size): _entries(entries), _size(size) {
+  clear();
+}
+
+/*
+ * Remove all glyphs from the cache, e.g. after a font table in RAM has been modified.
+ * The hit/miss counters are not affected.
+ */
+void UC1609GlyphCache::clear() {
+  for (uint8_t i = 0; i < _size; i++) {
+    _entries[i].glyph = nullptr;
+    _entries[i].scale = 0;
+    _entries[i].lastUse = 0;
+  }
+  _tick = 0;
+}
+
+/*
+ * Internal function returning the use stamp for an entry. When the 16-bit stamp wraps
+ * around all entries are aged to 0, which only makes the next few evictions approximate.
+ */
+uint16_t UC1609GlyphCache::_nextTick() {
+  if (++_tick == 0) {
+    for (uint8_t i = 0; i < _size; i++) {
+      _entries[i].lastUse = 0;
+    }
+    _tick = 1;
+  }
+  return _tick;
+}
+
+/*
+ * Look up a scaled glyph and count a hit or a miss.
+ * return: pointer to the cached glyph data, or nullptr if it is not in the cache
+ */
+uint8_t *UC1609GlyphCache::find(const uint8_t *glyph, uint8_t scale, bool antiAliasing) {
+  for (uint8_t i = 0; i < _size; i++) {
+    UC1609GlyphCacheEntry &e = _entries[i];
+    if (e.glyph == glyph && e.scale == scale && e.antiAliasing == antiAliasing) {
+      e.lastUse = _nextTick();
+      _hits++;
+      return e.data;
+    }
+  }
+  _misses++;
+  return nullptr;
+}
+
+/*
+ * Claim the least recently used (or an unused) entry for a glyph that was not found.
+ * return: pointer to the data of the entry, the caller fills in the scaled glyph,
+ *         or nullptr if the cache has no entries
+ */
+uint8_t *UC1609GlyphCache::store(const uint8_t *glyph, uint8_t scale, bool antiAliasing) {
+  if (_size == 0) return nullptr;
+
+  UC1609GlyphCacheEntry *victim = &_entries[0];
+  for (uint8_t i = 0; i < _size; i++) {
+    UC1609GlyphCacheEntry &e = _entries[i];
+    if (e.scale == 0) {
+      victim = &e;
+      break;
+    }
+    if (e.lastUse < victim->lastUse) victim = &e;
+  }
+  victim->glyph = glyph;
+  victim->scale = scale;
+  victim->antiAliasing = antiAliasing;
+  victim->lastUse = _nextTick();
+  return victim->data;
+}
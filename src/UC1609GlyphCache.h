@@ -0,0 +1,60 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional RAM cache of scaled glyphs for the UC1609 library. Screens that keep
+ *               printing the same small set of characters (digits, units, a few labels) at
+ *               font scale 2 can keep the stretched and anti-aliased glyphs in RAM instead of
+ *               recomputing them for every write(). The least recently used entry is replaced
+ *               on a miss, hit/miss counters help to size the cache for a product.
+ *
+ *               UC1609GlyphCacheEntry entries[12];          // 12 x 30 bytes on AVR
+ *               UC1609GlyphCache glyphCache(entries, 12);
+ *               lcd.setGlyphCache(&glyphCache);
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_GLYPH_CACHE_H
+#define UC1609_GLYPH_CACHE_H
+
+#include <stdint.h>
+
+// bytes of scaled glyph data per entry, a double-size glyph is 12 columns x 2 pages
+#ifndef UC1609_GLYPH_CACHE_BYTES
+#define UC1609_GLYPH_CACHE_BYTES 24
+#endif
+
+/*
+ * A glyph is identified by its address in the font table (which identifies both the font
+ * and the character), the font scale and whether it was anti-aliased.
+ */
+struct UC1609GlyphCacheEntry {
+  const uint8_t *glyph;
+  uint8_t scale;          // 0 for an unused entry
+  bool antiAliasing;
+  uint16_t lastUse;
+  uint8_t data[UC1609_GLYPH_CACHE_BYTES];
+};
+
+class UC1609GlyphCache {
+  public:
+    UC1609GlyphCache(UC1609GlyphCacheEntry *entries, uint8_t size);
+
+    uint8_t *find(const uint8_t *glyph, uint8_t scale, bool antiAliasing);
+    uint8_t *store(const uint8_t *glyph, uint8_t scale, bool antiAliasing);
+    void clear();
+
+    uint32_t hits() const { return _hits; }
+    uint32_t misses() const { return _misses; }
+    void resetStats() { _hits = 0; _misses = 0; }
+
+  private:
+    UC1609GlyphCacheEntry *_entries;
+    uint8_t _size;
+    uint16_t _tick{0};
+    uint32_t _hits{0};
+    uint32_t _misses{0};
+
+    uint16_t _nextTick();
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional character-cell buffer for text screens of the UC1609 library, see UC1609TextBuffer.h.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include <string.h>
+#include "UC1609TextBuffer.h"
+
+/*
+ * Create a buffer of blank cells. All cells are dirty, so that the first refresh()
+ * draws the whole screen whatever the display shows.
+ */
+UC1609TextBuffer::UC1609TextBuffer() {
+  memset(_cells, ' ', sizeof(_cells));
+  memset(_inverseMap, 0, sizeof(_inverseMap));
+  invalidate();
+}
+
+/*
+ * Store a character with the current attribute, the cell only becomes dirty when
+ * its character or attribute changes.
+ * param: uint8_t col - 0-31 cell column
+ *        uint8_t row - 0-7 cell row
+ *        uint8_t ch - character code
+ */
+void UC1609TextBuffer::put(uint8_t col, uint8_t row, uint8_t ch) {
+  if (col >= UC1609_TEXT_COLUMNS || row >= UC1609_TEXT_ROWS) return;
+  uint16_t i = _index(col, row);
+  uint8_t bit = _bit(col);
+  bool inverse = _inverseMap[i >> 3] & bit;
+  if (_cells[i] == ch && inverse == _inverse) return;
+
+  _cells[i] = ch;
+  if (_inverse)
+    _inverseMap[i >> 3] |= bit;
+  else
+    _inverseMap[i >> 3] &= ~bit;
+  _dirty[i >> 3] |= bit;
+}
+
+/*
+ * Blank all cells, only the cells that were not blank are redrawn by refresh().
+ */
+void UC1609TextBuffer::clear() {
+  bool inverse = _inverse;
+  _inverse = false;
+  for (uint8_t row = 0; row < UC1609_TEXT_ROWS; row++) {
+    for (uint8_t col = 0; col < UC1609_TEXT_COLUMNS; col++) {
+      put(col, row, ' ');
+    }
+  }
+  _inverse = inverse;
+}
+
+/*
+ * Blank all cells and mark them clean, the buffer then matches a cleared display.
+ */
+void UC1609TextBuffer::reset() {
+  memset(_cells, ' ', sizeof(_cells));
+  memset(_inverseMap, 0, sizeof(_inverseMap));
+  memset(_dirty, 0, sizeof(_dirty));
+}
+
+/*
+ * Mark all cells dirty, e.g. after something else has been drawn over the text.
+ */
+void UC1609TextBuffer::invalidate() {
+  memset(_dirty, 0xFF, sizeof(_dirty));
+}
+
+bool UC1609TextBuffer::isLineDirty(uint8_t row) const {
+  const uint8_t *line = &_dirty[_index(0, row) >> 3];
+  for (uint8_t i = 0; i < UC1609_TEXT_COLUMNS / 8; i++) {
+    if (line[i]) return true;
+  }
+  return false;
+}
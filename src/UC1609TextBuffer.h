@@ -0,0 +1,59 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional character-cell buffer for text screens of the UC1609 library. With a
+ *               buffer attached, write() and print() at font scale 1 only update a grid of
+ *               32 x 8 character codes, and refresh() redraws the cells that have changed since
+ *               the previous refresh(), merging adjacent changed cells of a line into a single
+ *               data stream. A screen is simply printed again to update it, without a
+ *               clearDisplay(), for 320 bytes of RAM instead of the 1.5kB of a framebuffer.
+ *
+ *               UC1609TextBuffer textBuffer;
+ *               lcd.setTextBuffer(&textBuffer);
+ *               lcd.setCursor(0, 2);
+ *               lcd.print(temperature);
+ *               lcd.refresh();
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_TEXT_BUFFER_H
+#define UC1609_TEXT_BUFFER_H
+
+#include <stdint.h>
+
+// 6-pixel cells (5x7 font + padding) of the 192 x 64 display
+#define UC1609_TEXT_COLUMNS 32
+#define UC1609_TEXT_ROWS    8
+
+class UC1609TextBuffer {
+  public:
+    UC1609TextBuffer();
+
+    void put(uint8_t col, uint8_t row, uint8_t ch);
+    uint8_t get(uint8_t col, uint8_t row) const { return _cells[row * UC1609_TEXT_COLUMNS + col]; }
+    void clear();
+    void reset();
+    void invalidate();
+
+    // attribute of the characters put from now on
+    void setInverse(bool inverse) { _inverse = inverse; }
+    bool isInverse(uint8_t col, uint8_t row) const { return _test(_inverseMap, col, row); }
+
+    bool isDirty(uint8_t col, uint8_t row) const { return _test(_dirty, col, row); }
+    bool isLineDirty(uint8_t row) const;
+    void markClean(uint8_t col, uint8_t row) { _dirty[_index(col, row) >> 3] &= ~_bit(col); }
+
+  private:
+    uint8_t _cells[UC1609_TEXT_COLUMNS * UC1609_TEXT_ROWS];
+    uint8_t _dirty[UC1609_TEXT_COLUMNS * UC1609_TEXT_ROWS / 8];       // one bit per cell
+    uint8_t _inverseMap[UC1609_TEXT_COLUMNS * UC1609_TEXT_ROWS / 8];
+    bool _inverse{false};
+
+    static uint16_t _index(uint8_t col, uint8_t row) { return row * UC1609_TEXT_COLUMNS + col; }
+    static uint8_t _bit(uint8_t col) { return 1 << (col & 0x07); }
+    static bool _test(const uint8_t *map, uint8_t col, uint8_t row) {
+      return map[_index(col, row) >> 3] & _bit(col);
+    }
+};
+
+#endif
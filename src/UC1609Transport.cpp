@@ -0,0 +1,130 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional transports for the byte output of the UC1609 library, see UC1609Transport.h.
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#include "UC1609Transport.h"
+
+/*
+ * Default block and command paths of a transport, one write() per byte.
+ */
+void UC1609Transport::write(uint8_t *buf, uint16_t len) {
+  for (uint16_t i = 0; i < len; i++) {
+    write(buf[i]);
+  }
+}
+
+void UC1609Transport::writeCommands(const uint8_t *cmds, uint8_t len) {
+  for (uint8_t i = 0; i < len; i++) {
+    write(cmds[i]);
+  }
+}
+
+/*
+ * Set up SCK and MOSI, SCK idles low (SPI mode 0). On AVR the port register and bit mask
+ * of each pin are looked up once here, like the CS and CD pins of the UC1609 class.
+ */
+void UC1609BitBangTransport::begin() {
+  digitalWrite(_sck, LOW);
+  pinMode(_sck, OUTPUT);
+  pinMode(_mosi, OUTPUT);
+#ifdef __AVR__
+  _sckPort = portOutputRegister(digitalPinToPort(_sck));
+  _mosiPort = portOutputRegister(digitalPinToPort(_mosi));
+  _sckMask = digitalPinToBitMask(_sck);
+  _mosiMask = digitalPinToBitMask(_mosi);
+#endif
+}
+
+#ifdef __AVR__
+#define BITBANG_BIT(mask) \
+  if (data & (mask)) *_mosiPort |= _mosiMask; else *_mosiPort &= ~_mosiMask; \
+  *_sckPort |= _sckMask; \
+  *_sckPort &= ~_sckMask;
+#else
+#define BITBANG_BIT(mask) \
+  digitalWrite(_mosi, (data & (mask)) ? HIGH : LOW); \
+  digitalWrite(_sck, HIGH); \
+  digitalWrite(_sck, LOW);
+#endif
+
+/*
+ * Shift a byte out MSB first, the controller samples MOSI at the rising edge of SCK. The
+ * 8 bits are unrolled, there is no loop counter or shift between the edges.
+ */
+void UC1609BitBangTransport::write(uint8_t data) {
+  BITBANG_BIT(0x80)
+  BITBANG_BIT(0x40)
+  BITBANG_BIT(0x20)
+  BITBANG_BIT(0x10)
+  BITBANG_BIT(0x08)
+  BITBANG_BIT(0x04)
+  BITBANG_BIT(0x02)
+  BITBANG_BIT(0x01)
+}
+
+void UC1609BitBangTransport::write(uint8_t *buf, uint16_t len) {
+  while (len--) {
+    write(*buf++);
+  }
+}
+
+/*
+ * Internal helper of the capture: start a record, return false and flag the overflow when
+ * the buffer has no room for it.
+ */
+static bool _startRecord(uint8_t *buf, uint16_t size, uint16_t &length, uint8_t type, bool &overflow) {
+  if (length + 3 > size) {
+    overflow = true;
+    return false;
+  }
+  buf[length++] = type;
+  buf[length++] = 0;
+  return true;
+}
+
+/*
+ * Record a data byte, consecutive data bytes of a transaction share one record of up to
+ * 255 bytes.
+ */
+void UC1609CaptureTransport::write(uint8_t data) {
+  _dataBytes++;
+  if (!_open || _buf[_record + 1] == 255) {
+    _open = _startRecord(_buf, _size, _length, CAPTURE_DATA, _overflow);
+    if (!_open) return;
+    _record = _length - 2;
+  }
+  if (_length == _size) {
+    _overflow = true;
+    return;
+  }
+  _buf[_length++] = data;
+  _buf[_record + 1]++;
+}
+
+/*
+ * Record the command bytes sent in one CD-low window.
+ */
+void UC1609CaptureTransport::writeCommands(const uint8_t *cmds, uint8_t len) {
+  _commandBytes += len;
+  _open = false;
+  if (_length + 2 + len > _size || !_startRecord(_buf, _size, _length, CAPTURE_COMMAND, _overflow)) {
+    _overflow = true;
+    return;
+  }
+  _buf[_length - 1] = len;
+  for (uint8_t i = 0; i < len; i++) {
+    _buf[_length++] = cmds[i];
+  }
+}
+
+void UC1609CaptureTransport::clear() {
+  _length = 0;
+  _open = false;
+  _overflow = false;
+  _commandBytes = 0;
+  _dataBytes = 0;
+  _transactions = 0;
+}
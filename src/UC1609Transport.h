@@ -0,0 +1,112 @@
+/*
+ * Library Name: UC1609h
+ * Description:  Optional transports for the byte output of the UC1609 library. By default the
+ *               UC1609 class sends through the global SPI object at its own clock (see
+ *               setSpiClock()). A transport set with setTransport() before begin() takes over
+ *               the SPI transaction and the bytes, while CS and CD stay with the UC1609 class:
+ *               commands arrive as one block in writeCommands(), with CD low, and data in
+ *               write(), byte by byte or in blocks.
+ *
+ *                 UC1609SpiTransport       any SPIClass (e.g. a second SPI peripheral), own clock
+ *                 UC1609BitBangTransport   SCK and MOSI on any two pins, unrolled, SPI mode 0
+ *                 UC1609CaptureTransport   records command and data frames into a buffer, e.g.
+ *                                          for tests on the host or to replay them elsewhere
+ *
+ *               Other interfaces, such as a USART in master SPI mode, derive from
+ *               UC1609Transport.
+ *
+ *               UC1609SpiTransport spi1(SPI1, 16000000UL);
+ *               lcd.setTransport(&spi1);
+ *               lcd.begin();
+ * Author:       Henry Cheung (E-Tinkers), Tech Studio Design LLP
+ * Github:       https://github.com/e-tinkers/uc1609
+ */
+
+#ifndef UC1609_TRANSPORT_H
+#define UC1609_TRANSPORT_H
+
+#include "UC1609.h"
+
+// record types of UC1609CaptureTransport, each record is: type, length, `length` bytes
+#define CAPTURE_COMMAND     0
+#define CAPTURE_DATA        1
+
+class UC1609Transport {
+  public:
+    virtual void begin() {}
+    virtual void setClock(uint32_t clock) { (void) clock; }
+    virtual void beginTransaction() {}
+    virtual void endTransaction() {}
+    virtual void write(uint8_t data) = 0;
+    // like SPI.transfer(buf, len) the content of buf may be overwritten
+    virtual void write(uint8_t *buf, uint16_t len);
+    virtual void writeCommands(const uint8_t *cmds, uint8_t len);
+};
+
+class UC1609SpiTransport: public UC1609Transport {
+  public:
+    UC1609SpiTransport(SPIClass &spi = SPI, uint32_t clock = SPI_CLOCK, uint8_t dataMode = SPI_MODE0):
+      _spi(spi), _settings(clock, MSBFIRST, dataMode), _dataMode(dataMode) {}
+
+    void begin() override { _spi.begin(); }
+    void setClock(uint32_t clock) override { _settings = SPISettings(clock, MSBFIRST, _dataMode); }
+    void beginTransaction() override { _spi.beginTransaction(_settings); }
+    void endTransaction() override { _spi.endTransaction(); }
+    void write(uint8_t data) override { _spi.transfer(data); }
+    void write(uint8_t *buf, uint16_t len) override { _spi.transfer(buf, len); }
+
+  private:
+    SPIClass &_spi;
+    SPISettings _settings;
+    uint8_t _dataMode;
+};
+
+class UC1609BitBangTransport: public UC1609Transport {
+  public:
+    UC1609BitBangTransport(uint8_t sck, uint8_t mosi): _sck(sck), _mosi(mosi) {}
+
+    void begin() override;
+    void write(uint8_t data) override;
+    void write(uint8_t *buf, uint16_t len) override;
+
+  private:
+    uint8_t _sck;
+    uint8_t _mosi;
+#ifdef __AVR__
+    volatile uint8_t *_sckPort;
+    volatile uint8_t *_mosiPort;
+    uint8_t _sckMask;
+    uint8_t _mosiMask;
+#endif
+};
+
+class UC1609CaptureTransport: public UC1609Transport {
+  public:
+    UC1609CaptureTransport(uint8_t *buf, uint16_t size): _buf(buf), _size(size) {}
+
+    void beginTransaction() override { _transactions++; }
+    void endTransaction() override { _open = false; }
+    void write(uint8_t data) override;
+    void writeCommands(const uint8_t *cmds, uint8_t len) override;
+
+    const uint8_t *records() const { return _buf; }
+    uint16_t length() const { return _length; }
+    bool overflowed() const { return _overflow; }
+    uint32_t commandBytes() const { return _commandBytes; }
+    uint32_t dataBytes() const { return _dataBytes; }
+    uint32_t transactions() const { return _transactions; }
+    void clear();
+
+  private:
+    uint8_t *_buf;
+    uint16_t _size;
+    uint16_t _length{0};
+    uint16_t _record{0};    // data record bytes are appended to, while _open
+    bool _open{false};
+    bool _overflow{false};
+    uint32_t _commandBytes{0};
+    uint32_t _dataBytes{0};
+    uint32_t _transactions{0};
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef __DISPLAY_FONTS_H
 #define __DISPLAY_FONTS_H
 
+#include "UC1609Flash.h"
+
 // Only numeric and symbols (0x20-0x3A) font (27-char), uses 135 + 4 bytes
 FlashMem(font5x7_numeric) = {
   0x05, // width